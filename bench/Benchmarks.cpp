@@ -0,0 +1,544 @@
+#include <benchmark/benchmark.h>
+#include <array>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "Global.hpp"
+#include "Board.hpp"
+#include "GetTetromino.hpp"
+#include "Tetromino.hpp"
+#include "Randomizer.hpp"
+#include "PieceQueue.hpp"
+#include "GameState.hpp"
+#include "ThreadPool.hpp"
+#include "MoveGenerator.hpp"
+#include "TranspositionTable.hpp"
+#include "Bot.hpp"
+#include "BatchFeatures.hpp"
+
+//Every fixture is generated from this seed, so the numbers can be compared between runs and machines.
+constexpr unsigned FIXTURE_SEED = 20240101;
+
+//How many different tetrominoes every benchmark cycles through, so that branch predictors can't learn a single case.
+constexpr unsigned char FIXTURE_PIECES = 64;
+
+//The top rows are always left empty so that the tetrominoes have room to spawn.
+constexpr unsigned char FIXTURE_EMPTY_ROWS = ROWS / 4;
+
+//By default, a benchmark is a regression if it's this many percent slower than the baseline.
+constexpr double DEFAULT_REGRESSION_THRESHOLD = 10;
+
+//i_density is the chance (in percent) of every cell being filled. No row is ever full.
+static Board make_board(unsigned char i_density, unsigned i_seed)
+{
+	Board board;
+
+	std::mt19937 random_engine(i_seed);
+
+	for (unsigned char a = FIXTURE_EMPTY_ROWS; a < ROWS; a++)
+	{
+		for (unsigned char b = 0; b < COLUMNS; b++)
+		{
+			if (random_engine() % 100 < i_density)
+			{
+				board.set_cell(b, a, static_cast<unsigned char>(1 + random_engine() % 7));
+			}
+		}
+
+		if (1 == board.is_row_full(a))
+		{
+			board.set_cell(static_cast<unsigned char>(random_engine() % COLUMNS), a, 0);
+		}
+	}
+
+	return board;
+}
+
+//Tetrominoes of random shapes, moved and turned to random places above the board.
+static std::vector<Tetromino> make_pieces(const Board& i_board, unsigned i_seed)
+{
+	std::mt19937 random_engine(i_seed);
+
+	std::vector<Tetromino> pieces;
+
+	pieces.reserve(FIXTURE_PIECES);
+
+	while (pieces.size() < FIXTURE_PIECES)
+	{
+		Tetromino tetromino(static_cast<unsigned char>(random_engine() % 7), i_board);
+
+		for (unsigned char a = random_engine() % 4; 0 < a; a--)
+		{
+			tetromino.rotate(1, i_board);
+		}
+
+		for (unsigned char a = random_engine() % COLUMNS; 0 < a; a--)
+		{
+			if (0 == random_engine() % 2)
+			{
+				tetromino.move_left(i_board);
+			}
+			else
+			{
+				tetromino.move_right(i_board);
+			}
+		}
+
+		for (unsigned char a = random_engine() % FIXTURE_EMPTY_ROWS; 0 < a; a--)
+		{
+			tetromino.move_down(i_board);
+		}
+
+		pieces.push_back(tetromino);
+	}
+
+	return pieces;
+}
+
+//The range argument of most benchmarks is the fill density of the board.
+static void density_arguments(benchmark::internal::Benchmark* i_benchmark)
+{
+	for (int density : {0, 25, 50, 75})
+	{
+		i_benchmark->Arg(density);
+	}
+}
+
+static void BM_get_tetromino(benchmark::State& i_state)
+{
+	unsigned char shape = 0;
+
+	for (auto _ : i_state)
+	{
+		benchmark::DoNotOptimize(get_tetromino(shape, COLUMNS / 2, 1));
+
+		shape = (1 + shape) % 7;
+	}
+}
+BENCHMARK(BM_get_tetromino);
+
+//The tetromino is copied every iteration so that every call starts from the same place.
+template <bool (Tetromino::*Move)(const Board&)>
+static void BM_move(benchmark::State& i_state)
+{
+	Board board = make_board(static_cast<unsigned char>(i_state.range(0)), FIXTURE_SEED);
+
+	std::vector<Tetromino> pieces = make_pieces(board, FIXTURE_SEED);
+
+	unsigned char piece = 0;
+
+	for (auto _ : i_state)
+	{
+		Tetromino tetromino = pieces[piece];
+
+		benchmark::DoNotOptimize((tetromino.*Move)(board));
+
+		piece = (1 + piece) % FIXTURE_PIECES;
+	}
+}
+BENCHMARK_TEMPLATE(BM_move, &Tetromino::move_down)->Name("BM_move_down")->Apply(density_arguments);
+BENCHMARK_TEMPLATE(BM_move, &Tetromino::move_left)->Name("BM_move_left")->Apply(density_arguments);
+BENCHMARK_TEMPLATE(BM_move, &Tetromino::move_right)->Name("BM_move_right")->Apply(density_arguments);
+
+//The pieces are pushed against a wall first, so that most turns need a wall kick.
+static void BM_rotate(benchmark::State& i_state)
+{
+	Board board = make_board(static_cast<unsigned char>(i_state.range(0)), FIXTURE_SEED);
+
+	std::vector<Tetromino> pieces = make_pieces(board, FIXTURE_SEED);
+
+	for (unsigned char a = 0; a < FIXTURE_PIECES; a++)
+	{
+		if (0 == a % 2)
+		{
+			while (1 == pieces[a].move_left(board));
+		}
+		else
+		{
+			while (1 == pieces[a].move_right(board));
+		}
+	}
+
+	unsigned char piece = 0;
+
+	for (auto _ : i_state)
+	{
+		Tetromino tetromino = pieces[piece];
+
+		benchmark::DoNotOptimize(tetromino.rotate(1 == piece % 2, board));
+
+		piece = (1 + piece) % FIXTURE_PIECES;
+	}
+}
+BENCHMARK(BM_rotate)->Apply(density_arguments);
+
+//The copies never had their ghost calculated, so this measures the uncached path.
+static void BM_get_ghost_minos(benchmark::State& i_state)
+{
+	Board board = make_board(static_cast<unsigned char>(i_state.range(0)), FIXTURE_SEED);
+
+	std::vector<Tetromino> pieces = make_pieces(board, FIXTURE_SEED);
+
+	unsigned char piece = 0;
+
+	for (auto _ : i_state)
+	{
+		Tetromino tetromino = pieces[piece];
+
+		benchmark::DoNotOptimize(tetromino.get_ghost_minos(board));
+
+		piece = (1 + piece) % FIXTURE_PIECES;
+	}
+}
+BENCHMARK(BM_get_ghost_minos)->Apply(density_arguments);
+
+static void BM_get_ghost_minos_cached(benchmark::State& i_state)
+{
+	Board board = make_board(static_cast<unsigned char>(i_state.range(0)), FIXTURE_SEED);
+
+	std::vector<Tetromino> pieces = make_pieces(board, FIXTURE_SEED);
+
+	for (Tetromino& tetromino : pieces)
+	{
+		tetromino.get_ghost_minos(board);
+	}
+
+	unsigned char piece = 0;
+
+	for (auto _ : i_state)
+	{
+		benchmark::DoNotOptimize(pieces[piece].get_ghost_minos(board));
+
+		piece = (1 + piece) % FIXTURE_PIECES;
+	}
+}
+BENCHMARK(BM_get_ghost_minos_cached)->Apply(density_arguments);
+
+static void BM_hard_drop(benchmark::State& i_state)
+{
+	Board board = make_board(static_cast<unsigned char>(i_state.range(0)), FIXTURE_SEED);
+
+	std::vector<Tetromino> pieces = make_pieces(board, FIXTURE_SEED);
+
+	unsigned char piece = 0;
+
+	for (auto _ : i_state)
+	{
+		Tetromino tetromino = pieces[piece];
+
+		tetromino.hard_drop(board);
+
+		benchmark::DoNotOptimize(tetromino);
+
+		piece = (1 + piece) % FIXTURE_PIECES;
+	}
+}
+BENCHMARK(BM_hard_drop)->Apply(density_arguments);
+
+//The board is copied every iteration, so this includes the cost of one Board copy.
+static void BM_update_matrix(benchmark::State& i_state)
+{
+	Board board = make_board(static_cast<unsigned char>(i_state.range(0)), FIXTURE_SEED);
+
+	std::vector<Tetromino> pieces = make_pieces(board, FIXTURE_SEED);
+
+	for (Tetromino& tetromino : pieces)
+	{
+		tetromino.hard_drop(board);
+	}
+
+	unsigned char piece = 0;
+
+	for (auto _ : i_state)
+	{
+		Board next_board = board;
+
+		pieces[piece].update_matrix(next_board);
+
+		benchmark::DoNotOptimize(next_board);
+
+		piece = (1 + piece) % FIXTURE_PIECES;
+	}
+}
+BENCHMARK(BM_update_matrix)->Apply(density_arguments);
+
+//The collapse that GameState::step does when the clear effect ends.
+//The range arguments are the number of full rows and the fill density of the rest of the board.
+static void BM_clear_lines(benchmark::State& i_state)
+{
+	Board board = make_board(static_cast<unsigned char>(i_state.range(1)), FIXTURE_SEED);
+
+	std::mt19937 random_engine(FIXTURE_SEED);
+
+	for (unsigned char a = 0; a < i_state.range(0); a++)
+	{
+		board.fill_row(static_cast<unsigned char>(FIXTURE_EMPTY_ROWS + random_engine() % (ROWS - FIXTURE_EMPTY_ROWS)), static_cast<unsigned char>(1 + a));
+	}
+
+	for (auto _ : i_state)
+	{
+		Board next_board = board;
+
+		benchmark::DoNotOptimize(next_board.clear_full_rows(0));
+	}
+}
+BENCHMARK(BM_clear_lines)->ArgsProduct({{1, 2, 4}, {25, 75}});
+
+//The whole search for every placement of a tetromino, tucks and spins included. The items are tetrominoes.
+static void BM_get_placements(benchmark::State& i_state)
+{
+	Board board = make_board(static_cast<unsigned char>(i_state.range(0)), FIXTURE_SEED);
+
+	MoveGenerator moves;
+
+	std::vector<Placement> placements;
+
+	std::vector<Tetromino> pieces = make_pieces(board, FIXTURE_SEED);
+
+	for (auto _ : i_state)
+	{
+		for (const Tetromino& tetromino : pieces)
+		{
+			get_placements(tetromino, board, moves, placements);
+
+			benchmark::DoNotOptimize(placements.data());
+		}
+	}
+
+	i_state.SetItemsProcessed(i_state.iterations() * pieces.size());
+}
+BENCHMARK(BM_get_placements)->Apply(density_arguments);
+
+//The matrices the bot measures: the board with every fixture tetromino hard dropped into it.
+static std::vector<Board> make_placements(unsigned char i_density)
+{
+	Board board = make_board(i_density, FIXTURE_SEED);
+
+	std::vector<Board> matrices;
+
+	for (Tetromino& tetromino : make_pieces(board, FIXTURE_SEED))
+	{
+		matrices.push_back(board);
+
+		tetromino.hard_drop(board);
+		tetromino.update_matrix(matrices.back());
+	}
+
+	return matrices;
+}
+
+//One matrix at a time with the reference. The items are matrices, to compare with BM_get_batch_features.
+static void BM_get_features(benchmark::State& i_state)
+{
+	std::vector<Board> matrices = make_placements(static_cast<unsigned char>(i_state.range(0)));
+
+	for (auto _ : i_state)
+	{
+		for (const Board& matrix : matrices)
+		{
+			benchmark::DoNotOptimize(get_features(matrix, 0, 0));
+		}
+	}
+
+	i_state.SetItemsProcessed(i_state.iterations() * matrices.size());
+}
+BENCHMARK(BM_get_features)->Apply(density_arguments);
+
+static void BM_get_batch_features(benchmark::State& i_state)
+{
+	std::vector<Board> matrices = make_placements(static_cast<unsigned char>(i_state.range(0)));
+
+	std::vector<BotFeatures> features;
+
+	std::vector<unsigned> line_points(matrices.size());
+
+	for (auto _ : i_state)
+	{
+		get_batch_features(matrices, line_points, 0, features);
+
+		benchmark::DoNotOptimize(features.data());
+	}
+
+	i_state.SetItemsProcessed(i_state.iterations() * matrices.size());
+}
+BENCHMARK(BM_get_batch_features)->Apply(density_arguments);
+
+//Remembers the real time of every run, so it can be compared with a baseline after all the benchmarks are done.
+class RegressionReporter : public benchmark::ConsoleReporter
+{
+	std::map<std::string, double> real_times;
+public:
+	void ReportRuns(const std::vector<Run>& i_runs) override
+	{
+		for (const Run& run : i_runs)
+		{
+			if (0 < run.iterations)
+			{
+				real_times[run.benchmark_name()] = run.GetAdjustedRealTime() * get_nanoseconds(benchmark::GetTimeUnitString(run.time_unit));
+			}
+		}
+
+		ConsoleReporter::ReportRuns(i_runs);
+	}
+
+	static double get_nanoseconds(const std::string& i_time_unit)
+	{
+		if ("us" == i_time_unit)
+		{
+			return 1e3;
+		}
+		else if ("ms" == i_time_unit)
+		{
+			return 1e6;
+		}
+		else if ("s" == i_time_unit)
+		{
+			return 1e9;
+		}
+
+		return 1;
+	}
+
+	const std::map<std::string, double>& get_real_times() const
+	{
+		return real_times;
+	}
+};
+
+//Reads the real times (in nanoseconds) out of a file written with --benchmark_out_format=json.
+//Google Benchmark writes every key on its own line, so we don't need a full JSON parser.
+static bool load_baseline(const std::string& i_path, std::map<std::string, double>& i_real_times)
+{
+	std::ifstream file(i_path);
+
+	if (0 == file.is_open())
+	{
+		return 0;
+	}
+
+	double real_time = 0;
+
+	std::string line;
+	std::string name;
+
+	while (std::getline(file, line))
+	{
+		std::size_t colon = line.find(':');
+
+		if (std::string::npos == colon)
+		{
+			continue;
+		}
+
+		std::size_t value_start = line.find_first_not_of(" \"", 1 + colon);
+		std::size_t value_end = line.find_last_not_of(" \",");
+
+		std::string key = line.substr(0, colon);
+		std::string value = std::string::npos == value_start ? "" : line.substr(value_start, 1 + value_end - value_start);
+
+		if (std::string::npos != key.find("\"name\""))
+		{
+			name = value;
+		}
+		else if (std::string::npos != key.find("\"real_time\""))
+		{
+			real_time = std::strtod(value.c_str(), nullptr);
+		}
+		else if (std::string::npos != key.find("\"time_unit\"") && 0 == name.empty())
+		{
+			i_real_times[name] = real_time * RegressionReporter::get_nanoseconds(value);
+
+			name.clear();
+		}
+	}
+
+	return 1;
+}
+
+//Besides the usual Google Benchmark flags, this understands:
+//--regression_baseline=<json file>   compare against an earlier --benchmark_out run and exit with 1 on a regression.
+//--regression_threshold=<percent>    how much slower a benchmark can get before it counts as a regression.
+int main(int i_argument_count, char** i_arguments)
+{
+	double regression_threshold = DEFAULT_REGRESSION_THRESHOLD;
+
+	std::string baseline_path;
+
+	std::vector<char*> arguments;
+
+	for (int a = 0; a < i_argument_count; a++)
+	{
+		if (0 == std::strncmp(i_arguments[a], "--regression_baseline=", 22))
+		{
+			baseline_path = 22 + i_arguments[a];
+		}
+		else if (0 == std::strncmp(i_arguments[a], "--regression_threshold=", 23))
+		{
+			regression_threshold = std::strtod(23 + i_arguments[a], nullptr);
+		}
+		else
+		{
+			arguments.push_back(i_arguments[a]);
+		}
+	}
+
+	int argument_count = static_cast<int>(arguments.size());
+
+	benchmark::Initialize(&argument_count, arguments.data());
+
+	if (1 == benchmark::ReportUnrecognizedArguments(argument_count, arguments.data()))
+	{
+		return 1;
+	}
+
+	std::map<std::string, double> baseline;
+
+	if (0 == baseline_path.empty() && 0 == load_baseline(baseline_path, baseline))
+	{
+		std::cerr << "Can't read the baseline " << baseline_path << std::endl;
+
+		return 1;
+	}
+
+	RegressionReporter reporter;
+
+	benchmark::RunSpecifiedBenchmarks(&reporter);
+	benchmark::Shutdown();
+
+	if (1 == baseline_path.empty())
+	{
+		return 0;
+	}
+
+	unsigned regressions = 0;
+
+	for (const std::pair<const std::string, double>& result : reporter.get_real_times())
+	{
+		std::map<std::string, double>::const_iterator baseline_result = baseline.find(result.first);
+
+		if (baseline.end() == baseline_result || 0 >= baseline_result->second)
+		{
+			continue;
+		}
+
+		double change = 100 * (result.second / baseline_result->second - 1);
+
+		if (regression_threshold < change)
+		{
+			regressions++;
+
+			std::cout << "REGRESSION " << result.first << ": " << baseline_result->second << " ns -> " << result.second << " ns (+" << change << "%)" << std::endl;
+		}
+	}
+
+	std::cout << regressions << " regressions over " << regression_threshold << "%" << std::endl;
+
+	return 0 == regressions ? 0 : 1;
+}
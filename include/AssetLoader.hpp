@@ -0,0 +1,55 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+//Finds every asset the game uses once, from a manifest or a pack, and decodes them all in the background.
+class AssetLoader
+{
+	struct Asset
+	{
+		bool is_font;
+		bool loaded;
+
+		//Where the bytes are inside the pack, when we use one.
+		std::size_t pack_offset;
+		std::size_t pack_size;
+
+		std::string name;
+		//The first candidate path that exists. Empty if none of them do.
+		std::string path;
+
+		sf::Font font;
+
+		sf::Image image;
+	};
+
+	bool use_pack;
+
+	std::vector<Asset> assets;
+
+	MappedFile pack;
+
+	const Asset* find(const std::string& i_name) const;
+
+	void decode(Asset& i_asset);
+	void parse_manifest(const std::string& i_text);
+public:
+	AssetLoader();
+
+	//Returns 0 if the manifest can't be read, in which case the built-in one is used.
+	bool load_manifest(const std::string& i_path);
+	bool open_pack(const std::string& i_path);
+	//Packs every asset the manifest found into a single file, so they can all be mapped at once.
+	bool save_pack(const std::string& i_path) const;
+
+	//nullptr if the asset is missing or couldn't be decoded.
+	const sf::Font* get_font(const std::string& i_name) const;
+
+	const sf::Image* get_image(const std::string& i_name) const;
+
+	//Decodes every asset on the pool. The pool has to be waited on before anything is read.
+	void start_loading(ThreadPool& i_thread_pool);
+};
@@ -0,0 +1,8 @@
+#pragma once
+
+#include <vector>
+
+//The same as get_features for every matrix, into i_features so that its memory can be reused.
+//The matrices are measured side by side in SIMD lanes, 8 at a time with AVX2, 4 with SSE2 and 1 without either. get_features stays the reference they have to match.
+//All the matrices have to be the same size, like the placements of one tetromino are.
+void get_batch_features(const std::vector<Board>& i_matrices, const std::vector<unsigned>& i_line_points, unsigned i_locked_rows, std::vector<BotFeatures>& i_features);
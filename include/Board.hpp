@@ -0,0 +1,74 @@
+#pragma once
+
+#include <array>
+
+//Every row is stored as a bitmask (bit x set = cell x occupied), so collision checks and full line checks are single word operations.
+//The colors are kept in a separate plane and are only needed for rendering and the mono line bonus.
+//The size is chosen at runtime, up to MAX_COLUMNS x MAX_ROWS, so a different board size doesn't need a different build.
+class Board
+{
+	unsigned char height;
+	unsigned char width;
+
+	//The bitmask of a row with every cell occupied.
+	unsigned full_row;
+	//Increased every time the board changes, so that anything computed from it can tell when it's out of date.
+	unsigned revision;
+
+	//The Zobrist hash of the cells and their colors, updated with every change instead of being computed from scratch.
+	unsigned long long hash;
+
+	//How many rows there are from the bottom up to and including the highest occupied cell of every column.
+	std::array<unsigned char, MAX_COLUMNS> column_heights;
+	//The color that every occupied cell of a row has, MIXED_ROW_COLOR if they have different ones and 0 for an empty row.
+	//Kept up to date, so that finding the rows that can still become mono lines doesn't need to look at every cell.
+	std::array<unsigned char, MAX_ROWS> row_colors;
+
+	std::array<unsigned, MAX_ROWS> rows;
+
+	std::array<std::array<unsigned char, MAX_COLUMNS>, MAX_ROWS> colors;
+
+	void update_column_heights();
+	void update_row_color(unsigned char i_y);
+public:
+	Board();
+	Board(unsigned char i_width, unsigned char i_height);
+
+	bool collides(const std::array<Position, 4>& i_minos, signed char i_offset_x, signed char i_offset_y) const;
+	bool is_row_full(unsigned char i_y) const;
+	bool is_row_mono(unsigned char i_y) const;
+
+	//Removes every full row above the locked rows at the bottom and moves the rest down in a single pass.
+	//Returns how many rows were removed.
+	unsigned char clear_full_rows(unsigned char i_locked_rows);
+
+	//How many rows the minos can fall before they land.
+	unsigned char get_drop_distance(const std::array<Position, 4>& i_minos) const;
+
+	unsigned char get_cell(unsigned char i_x, unsigned char i_y) const;
+	unsigned char get_column_height(unsigned char i_x) const;
+	unsigned char get_height() const;
+	unsigned char get_row_color(unsigned char i_y) const;
+	unsigned char get_width() const;
+
+	//The key that a cell of this color at (i_x, i_y) adds to the hash. i_color has to be below CELL_COLORS.
+	static unsigned long long get_cell_key(unsigned char i_x, unsigned char i_y, unsigned char i_color);
+
+	//Boards of the same size with the same cells in the same colors have the same hash.
+	unsigned long long get_hash() const;
+
+	unsigned get_full_row() const;
+	unsigned get_revision() const;
+	unsigned get_row(unsigned char i_y) const;
+
+	//All at once, for loops that would otherwise call get_column_height, get_row_color or get_row for every one.
+	const std::array<unsigned char, MAX_COLUMNS>& get_column_heights() const;
+	const std::array<unsigned char, MAX_ROWS>& get_row_colors() const;
+	const std::array<unsigned, MAX_ROWS>& get_rows() const;
+
+	void clear();
+	void fill_row(unsigned char i_y, unsigned char i_color);
+	//Changes the size and clears the board. The size is clamped to what we support.
+	void resize(unsigned char i_width, unsigned char i_height);
+	void set_cell(unsigned char i_x, unsigned char i_y, unsigned char i_color);
+};
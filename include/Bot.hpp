@@ -0,0 +1,147 @@
+#pragma once
+
+#include <array>
+#include <string>
+#include <vector>
+
+//Everything the bot measures on a matrix after a placement, as indices into BotFeatures and BotWeights.
+enum class BotFeature : unsigned char
+{
+	//The heights of all the columns added up.
+	AggregateHeight,
+	//The height differences between neighboring columns added up.
+	Bumpiness,
+	//Changes between empty and occupied going down every column, with the floor counting as occupied.
+	ColumnTransitions,
+	//Holes in the row that the rising floor covers next. They stop mattering once it does.
+	FloorHoles,
+	//Empty cells with an occupied cell somewhere above them.
+	Holes,
+	//The points from SCORE_TABLE, including the mono line bonus.
+	LinePoints,
+	//Occupied cells in rows that aren't full yet but are still a single color, so they can become mono lines.
+	MonoCells,
+	//Changes between empty and occupied along every row that isn't empty, with the walls counting as occupied.
+	RowTransitions,
+	//Every empty cell with occupied cells or walls on both sides counts 1 plus the number of such cells right above it.
+	WellDepth
+};
+
+constexpr unsigned char BOT_FEATURE_COUNT = 9;
+
+using BotFeatures = std::array<float, BOT_FEATURE_COUNT>;
+//How much every feature is worth when the bot compares placements. Negative weights are penalties.
+using BotWeights = std::array<float, BOT_FEATURE_COUNT>;
+
+//Only what the bot has always looked at, so the new features start switched off.
+constexpr BotWeights DEFAULT_BOT_WEIGHTS = {-0.510066f, -0.184483f, 0, 0, -0.35663f, 0.0760666f, 0, 0, 0};
+
+//Placements where the next tetromino can't even spawn.
+constexpr float TOP_OUT_SCORE = -1000000;
+
+//A place where a tetromino can come to rest.
+struct Placement
+{
+	//The leftmost column of the minos.
+	signed char column;
+
+	unsigned char rotation;
+
+	float score;
+
+	std::array<Position, 4> minos;
+};
+
+//Everything measuring many placements needs, kept between calls so that it doesn't allocate.
+struct PlacementBuffers
+{
+	std::vector<BotFeatures> features;
+
+	std::vector<Board> matrices;
+
+	std::vector<unsigned> line_points;
+
+	std::vector<unsigned long long> keys;
+};
+
+class Bot
+{
+	//What every thread needs to go through the placements of the next tetromino.
+	struct Workspace
+	{
+		MoveGenerator moves;
+
+		PlacementBuffers buffers;
+
+		std::vector<Placement> placements;
+	};
+
+	bool has_plan;
+
+	unsigned char previous_keys;
+
+	unsigned plan_frames;
+	unsigned planned_piece;
+
+	BotWeights weights;
+
+	//Only used on the thread that asks for the input.
+	MoveGenerator moves;
+
+	Placement plan;
+
+	//Shared by the tasks of a search.
+	TranspositionTable table;
+
+	ThreadPool& thread_pool;
+
+	std::vector<Move> path;
+
+	//The placements of the current tetromino, kept so that planning doesn't allocate.
+	std::vector<Placement> placements;
+
+	//One for every thread of the pool and one for the thread that waits for them, indexed by ThreadPool::get_thread_index.
+	std::vector<Workspace> workspaces;
+public:
+	Bot(const BotWeights& i_weights, ThreadPool& i_thread_pool);
+
+	//Plays like a person would, pressing the keys of the shortest path to the best placement one at a time.
+	//The path is searched again every frame from wherever the tetromino is, so gravity moving it along the way doesn't matter.
+	InputFrame get_input(GameState& i_game);
+
+	//Tries every placement of the current tetromino followed by every placement of the next one.
+	Placement find_placement(GameState& i_game);
+
+	const TranspositionTable& get_table() const;
+
+	void reset();
+};
+
+//The weighted sum of the features.
+float evaluate_features(const BotFeatures& i_features, const BotWeights& i_weights);
+
+//How good the matrix looks with these weights, after a move that earned i_line_points.
+float evaluate_matrix(const Board& i_matrix, unsigned i_line_points, unsigned i_locked_rows, const BotWeights& i_weights);
+
+//Measures one matrix a row at a time. get_batch_features is faster for many matrices, and this is the reference it has to match.
+BotFeatures get_features(const Board& i_matrix, unsigned i_line_points, unsigned i_locked_rows);
+
+//The weights in the order of BotFeature, separated by commas, with enough digits to read back exactly.
+std::string format_weights(const BotWeights& i_weights);
+//Reads what format_weights writes. Features that are left out get a weight of 0.
+bool parse_weights(const std::string& i_text, BotWeights& i_weights);
+
+//The best score after any of i_placements of the next tetromino, which has i_shape, when the current one earned i_line_points.
+//The scores are looked up in i_table first, and the ones that had to be measured are stored there.
+float get_best_next_score(const Board& i_matrix, const std::vector<Placement>& i_placements, unsigned char i_shape, unsigned i_line_points, unsigned i_locked_rows, const BotWeights& i_weights, TranspositionTable& i_table, PlacementBuffers& i_buffers);
+
+//The transposition table key of the matrix that locking the minos into i_matrix makes, without making it.
+//0 if the minos complete a line, since then the rows move and the matrix has to be made to know its hash.
+unsigned long long get_placement_key(const Board& i_matrix, const std::array<Position, 4>& i_minos, unsigned char i_shape, unsigned i_line_points, unsigned i_locked_rows);
+
+//Every distinct placement the tetromino can reach with the moves of MoveGenerator, into i_placements so that its memory can be reused.
+//The placements are in the order of their shortest paths, and i_moves is left with the search, to ask it for them.
+void get_placements(const Tetromino& i_tetromino, const Board& i_matrix, MoveGenerator& i_moves, std::vector<Placement>& i_placements);
+
+//Locks the minos into the matrix and clears the full lines above the locked rows. Returns the points without the level multiplier.
+unsigned lock_placement(Board& i_matrix, const std::array<Position, 4>& i_minos, unsigned char i_shape, unsigned i_locked_rows);
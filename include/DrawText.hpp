@@ -3,4 +3,11 @@
 #include <SFML/Graphics.hpp>
 #include <string>
 
-void draw_text(unsigned short i_x, unsigned short i_y, const std::string& i_text, sf::RenderWindow& i_window);
\ No newline at end of file
+//Queues text that never changes, to be drawn with the other labels by draw_labels.
+void draw_label(unsigned short i_x, unsigned short i_y, const std::string& i_text);
+//Once at the end of every frame, on top of everything drawn before.
+void draw_labels(sf::RenderWindow& i_window);
+void draw_text(unsigned short i_x, unsigned short i_y, const std::string& i_text, sf::RenderWindow& i_window);
+
+//The font has to stay alive for as long as text is drawn.
+void set_text_font(const sf::Font& i_font);
@@ -0,0 +1,19 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+//Thin wrappers over the file calls of the platform, for files that have to survive a crash.
+//They work on descriptors, which are negative when a file couldn't be opened.
+int open_for_writing(const std::string& i_path, bool i_append);
+//-1 if it can't be read.
+long long get_file_size(int i_descriptor);
+bool write_all(int i_descriptor, const std::vector<unsigned char>& i_bytes);
+//Only returns once the bytes are on the disk.
+bool sync_file(int i_descriptor);
+void truncate_file(int i_descriptor, long long i_size);
+void close_file(int i_descriptor);
+//Renames i_source over i_destination, replacing it in one step.
+bool replace_file(const std::string& i_source, const std::string& i_destination);
+//Writes i_bytes to a temporary file, syncs it and then replaces i_path with it, so a crash leaves either the old file or the new one whole.
+bool replace_file_contents(const std::string& i_path, const std::vector<unsigned char>& i_bytes);
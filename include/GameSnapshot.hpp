@@ -0,0 +1,38 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <vector>
+
+//Everything that gets drawn from a GameState, copied so that it can be drawn while the next update runs.
+struct GameSnapshot
+{
+	bool advanced_mode;
+	bool game_over;
+
+	unsigned char clear_effect_timer;
+	unsigned char current_fall_speed;
+	//How many of next_shapes are shown.
+	unsigned char preview_count;
+
+	unsigned level;
+	unsigned lines_cleared;
+	unsigned locked_rows;
+	unsigned score;
+
+	std::chrono::microseconds accumulated_play_time;
+
+	//The upcoming shapes from the queue, the next one first.
+	std::array<unsigned char, MAX_PREVIEW> next_shapes;
+
+	std::vector<bool> clear_lines;
+
+	Board matrix;
+
+	Tetromino tetromino;
+
+	GameSnapshot();
+};
+
+//Doesn't allocate once the snapshot has held a game with the same board height.
+void take_snapshot(const GameState& i_game, GameSnapshot& i_snapshot);
@@ -0,0 +1,120 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <memory>
+#include <vector>
+
+//Bits of InputFrame::keys.
+constexpr unsigned char INPUT_ROTATE_CCW = 1;
+constexpr unsigned char INPUT_ROTATE_CW = 2;
+constexpr unsigned char INPUT_LEFT = 4;
+constexpr unsigned char INPUT_RIGHT = 8;
+constexpr unsigned char INPUT_SOFT_DROP = 16;
+constexpr unsigned char INPUT_HARD_DROP = 32;
+//The game rules ignore this one, it's only recorded so that replays show where the player paused.
+constexpr unsigned char INPUT_PAUSE = 64;
+
+//Points for clearing 1, 2, 3 and 4 lines at once, before multiplying by the level.
+constexpr std::array<unsigned, 4> SCORE_TABLE = {10, 30, 60, 100};
+//Extra points for every cleared line made of a single color.
+constexpr unsigned MONO_LINE_BONUS = 20;
+
+//The most key presses and releases a single fixed update takes. Any more wait for the next one.
+constexpr unsigned char MAX_INPUT_EVENTS = 16;
+
+//A key going down or up during a fixed update.
+struct InputEvent
+{
+	bool pressed;
+
+	//One of the INPUT_ bits.
+	unsigned char key;
+
+	//Microseconds since the start of the update, below FRAME_DURATION.
+	unsigned short time;
+};
+
+//The keys that are held down during one fixed update.
+struct InputFrame
+{
+	//The keys held at the end of the update.
+	unsigned char keys;
+	//Without events, the keys that changed are taken as pressed or released at the start of the update.
+	unsigned char event_count;
+
+	//Applied in the order of their time.
+	std::array<InputEvent, MAX_INPUT_EVENTS> events;
+};
+
+//All the game rules, without anything related to the window or rendering.
+struct GameState
+{
+	bool advanced_mode;
+	bool game_over;
+	bool hard_drop_pressed;
+	bool rotate_pressed;
+	//Set once the delayed auto shift is over, so the next shifts come every arr.
+	bool shift_charged;
+
+	unsigned char clear_effect_timer;
+	unsigned char current_fall_speed;
+	unsigned char fall_timer;
+	//How many upcoming shapes the queue holds, used by the next reset.
+	unsigned char preview_count;
+	unsigned char previous_keys;
+	//Used by every update, like the delayed auto shift and the auto repeat rate.
+	unsigned char soft_drop_factor;
+
+	//The auto repeat rate in microseconds. 0 shifts all the way to the wall at once.
+	unsigned arr;
+	//The delayed auto shift in microseconds.
+	unsigned das;
+	unsigned level;
+	unsigned lines_cleared;
+	unsigned locked_rows;
+	unsigned pieces_placed;
+	unsigned score;
+	//Microseconds until the next shift and the next soft drop. 0 means the next one happens as soon as the key is held.
+	unsigned shift_timer;
+	unsigned soft_drop_timer;
+
+	std::chrono::microseconds accumulated_play_time;
+
+	std::unique_ptr<Randomizer> randomizer;
+
+	std::vector<bool> clear_lines;
+
+	Board matrix;
+
+	PieceQueue piece_queue;
+
+	//Used by the next reset.
+	RandomizerType randomizer_type;
+
+	Tetromino tetromino;
+
+	GameState(unsigned i_seed);
+
+	//Turns, shifts and drops the tetromino for the keys that are held, if their timers allow it.
+	bool act(bool& i_hard_dropped);
+	//Runs the auto shift and the soft drop for this many microseconds of the update. After a hard drop only the timers run.
+	bool advance(unsigned i_time, bool i_hard_dropped);
+	//Moves one cell towards the held side, or all the way to the wall once charged with an auto repeat rate of 0.
+	bool shift();
+	bool soft_drop();
+	//Returns whether anything that is drawn on the screen changed.
+	bool step(const InputFrame& i_input);
+
+	void add_cleared_lines(unsigned i_lines, unsigned i_mono_lines);
+	void apply_event(const InputEvent& i_event);
+	void fill_locked_rows();
+	//Locks the tetromino at i_minos right away, clears the lines without the effect and spawns the next one.
+	//For headless games that skip the frames in between. i_frames is how long getting there would have taken, for the play time.
+	void place(const std::array<Position, 4>& i_minos, unsigned i_frames);
+	//Every game with the same seed, mode and inputs plays out exactly the same.
+	void reset(bool i_advanced_mode, unsigned i_seed);
+	//Changes the size of the matrix. The game has to be reset after this.
+	void resize(unsigned char i_width, unsigned char i_height);
+	void update_level_speed();
+};
@@ -1,3 +1,16 @@
 #pragma once
 
-std::vector<Position> get_tetromino(unsigned char i_shape, unsigned char i_x, unsigned char i_y);
\ No newline at end of file
+#include <array>
+
+//The minos of every shape in their spawn rotation, relative to the spawn position.
+constexpr std::array<std::array<Position, 4>, 7> TETROMINOES = {{
+	{{{1, -1}, {0, -1}, {-1, -1}, {-2, -1}}},
+	{{{0, 0}, {1, 0}, {-1, -1}, {-1, 0}}},
+	{{{0, 0}, {1, 0}, {1, -1}, {-1, 0}}},
+	{{{0, 0}, {0, -1}, {-1, -1}, {-1, 0}}},
+	{{{0, 0}, {1, -1}, {0, -1}, {-1, 0}}},
+	{{{0, 0}, {1, 0}, {0, -1}, {-1, 0}}},
+	{{{0, 0}, {1, 0}, {0, -1}, {-1, -1}}}
+}};
+
+std::array<Position, 4> get_tetromino(unsigned char i_shape, unsigned char i_x, unsigned char i_y);
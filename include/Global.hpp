@@ -2,16 +2,30 @@
 
 constexpr unsigned char CELL_SIZE = 8;
 constexpr unsigned char CLEAR_EFFECT_DURATION = 8;
+//The size of the classic matrix, used whenever no other size is asked for.
 constexpr unsigned char COLUMNS = 10;
 constexpr unsigned char LINES_TO_INCREASE_SPEED = 2;
-constexpr unsigned char MOVE_SPEED = 4;
+//Every row of the matrix is a bitmask in one unsigned, so the matrix can't be wider than this.
+constexpr unsigned char MAX_COLUMNS = 32;
+constexpr unsigned char MAX_ROWS = 48;
+//Empty, the 7 shapes and the locked rows.
+constexpr unsigned char CELL_COLORS = 9;
+//The row color of a row whose cells have more than one color.
+constexpr unsigned char MIXED_ROW_COLOR = 255;
+constexpr unsigned char MIN_COLUMNS = 4;
+constexpr unsigned char MIN_ROWS = 4;
 constexpr unsigned char ROWS = 20;
 constexpr unsigned char SCREEN_RESIZE = 4;
 constexpr unsigned char SOFT_DROP_SPEED = 4;
 constexpr unsigned char START_FALL_SPEED = 32;
 constexpr unsigned short FRAME_DURATION = 16667;
+//The delayed auto shift and the auto repeat rate, in microseconds. By default both are the 4 frames the game always used.
+constexpr unsigned DEFAULT_ARR = 4 * FRAME_DURATION;
+constexpr unsigned DEFAULT_DAS = 4 * FRAME_DURATION;
+//How many times faster than the starting gravity soft drop is, which by default gives the old 4 frames per row.
+constexpr unsigned char DEFAULT_SOFT_DROP_FACTOR = START_FALL_SPEED / SOFT_DROP_SPEED;
 struct Position
 {
-	char x;
-	char y;
+	signed char x;
+	signed char y;
 };
\ No newline at end of file
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+
+//How many key events can wait for the next fixed update.
+constexpr unsigned char INPUT_QUEUE_SIZE = 64;
+
+//The key presses and releases from the window, stamped when they arrived, handed out one fixed update at a time.
+//Events are kept in the order they were pushed, which is also the order of their time.
+//When the queue is full, the oldest event makes room but isn't lost: the next update gets it at its start, ahead of the queued events.
+//Only the last tap of a key is kept that way, since a key that went down and up again several times is one press and one release.
+class InputQueue
+{
+	struct Entry
+	{
+		bool pressed;
+
+		unsigned char key;
+
+		std::chrono::time_point<std::chrono::steady_clock> time;
+	};
+
+	unsigned char count;
+	//The keys that events made room for, and what they were left at by those events.
+	unsigned char dropped_keys;
+	unsigned char dropped_state;
+	unsigned char front;
+	//The keys held after the last event that was handed out.
+	unsigned char frame_keys;
+	//The keys held after the last event that was pushed, to ignore presses of keys that are already down.
+	unsigned char pushed_keys;
+
+	std::array<Entry, INPUT_QUEUE_SIZE> entries;
+
+	void drop_front();
+public:
+	InputQueue();
+
+	//The keys held after every event that was pushed.
+	unsigned char get_keys() const;
+
+	//Every event from before the end of the update, with its time relative to i_update_start.
+	//Events from before the update start count as happening right at its start.
+	InputFrame pop_frame(const std::chrono::time_point<std::chrono::steady_clock>& i_update_start);
+
+	//For when the window loses focus, since the releases won't reach us.
+	void release_all(const std::chrono::time_point<std::chrono::steady_clock>& i_time);
+	void push(unsigned char i_key, bool i_pressed, const std::chrono::time_point<std::chrono::steady_clock>& i_time);
+};
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+//One thread that runs file writes in the order they were pushed, so the game never waits for the disk.
+class IoWorker
+{
+	bool busy;
+	bool stopping;
+
+	std::condition_variable idle_condition;
+	std::condition_variable wake_condition;
+
+	std::deque<std::function<void()>> tasks;
+
+	std::mutex mutex;
+
+	std::thread thread;
+
+	void work();
+public:
+	IoWorker();
+	IoWorker(const IoWorker&) = delete;
+	//Every task that was pushed is finished first.
+	~IoWorker();
+
+	IoWorker& operator=(const IoWorker&) = delete;
+
+	void push(std::function<void()> i_task);
+	//Blocks until every task that was pushed is finished.
+	void wait();
+};
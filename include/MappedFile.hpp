@@ -0,0 +1,30 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+//A read-only view of a whole file, mapped into memory instead of read into a buffer.
+class MappedFile
+{
+	const unsigned char* data;
+
+	std::size_t size;
+
+	//Only used on Windows, where the mapping needs the file and mapping handles to stay open.
+	void* file_handle;
+	void* mapping_handle;
+public:
+	MappedFile();
+	MappedFile(const MappedFile&) = delete;
+	~MappedFile();
+
+	MappedFile& operator=(const MappedFile&) = delete;
+
+	bool open(const std::string& i_path);
+
+	const unsigned char* get_data() const;
+
+	std::size_t get_size() const;
+
+	void close();
+};
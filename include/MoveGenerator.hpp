@@ -0,0 +1,92 @@
+#pragma once
+
+#include <array>
+#include <bitset>
+#include <vector>
+
+//One key press on the way to a placement, in the order the search tries them, so that of two equally short paths the one with the earlier moves is kept.
+enum class Move : unsigned char
+{
+	Left,
+	Right,
+	//Holding the key until the tetromino can't go any further, which the delayed auto shift does with a single press.
+	DasLeft,
+	DasRight,
+	RotateCw,
+	RotateCcw,
+	//Holding soft drop until the tetromino lands.
+	SoftDrop
+};
+
+constexpr unsigned char MOVE_COUNT = 7;
+//How far outside the matrix the first mino can be. The other minos can be 3 cells away from it, and wall kicks can lift it above the top.
+constexpr unsigned char MOVE_MARGIN = 8;
+//Every rotation at every position of the first mino, which is all it takes to know where the other minos are.
+constexpr unsigned MOVE_STATES = 4 * (MAX_COLUMNS + 2 * MOVE_MARGIN) * (MAX_ROWS + 2 * MOVE_MARGIN);
+
+//Finds every state (position and rotation) that a tetromino can reach from where it is, breadth first, so the first path found to a state is one of the shortest.
+//The moves are the ones of Tetromino made on bare minos, with the same rotation table, so the wall kicks are exactly the ones the game does. That finds the placements under overhangs and the ones behind a kick, not just the ones a hard drop reaches.
+//Gravity isn't part of the search, it only ever does what a soft drop does.
+//Once the tetromino was dropped, it's only moved again after it lands, since it keeps falling otherwise. So we never go through every position in the air, only the ones before the first drop.
+class MoveGenerator
+{
+	struct State
+	{
+		//Whether a soft drop was part of the way here.
+		bool dropped;
+		//Whether the tetromino rests on something, so it can't be dropped.
+		bool landed;
+
+		Move move;
+
+		unsigned char rotation;
+
+		//The state that the move was made from.
+		unsigned short parent;
+
+		std::array<Position, 4> minos;
+	};
+
+	unsigned char shape;
+
+	//The highest occupied row of every column, or the height of the matrix for an empty one.
+	std::array<signed char, MAX_COLUMNS> surfaces;
+
+	//The rows of the matrix with the walls set, from 2 * MOVE_MARGIN rows above the top down to MOVE_MARGIN full rows below the bottom.
+	//Bit MOVE_MARGIN + x is column x, so a mino is checked with a single bit, walls and floor included.
+	std::array<unsigned long long, MAX_ROWS + 3 * MOVE_MARGIN> walled_rows;
+
+	std::bitset<MOVE_STATES> visited;
+
+	//The cells of every landing, so that the same cells reached in another rotation are only kept once.
+	std::vector<unsigned long long> landing_cells;
+
+	//The states where the tetromino rests on something, in the order they were found.
+	std::vector<unsigned short> landings;
+
+	std::vector<State> states;
+
+	//The same as Board::collides.
+	bool collides(const std::array<Position, 4>& i_minos, signed char i_offset_x, signed char i_offset_y) const;
+	//The same as Board::get_drop_distance.
+	signed char get_drop_distance(const std::array<Position, 4>& i_minos) const;
+	bool make_move(Move i_move, std::array<Position, 4>& i_minos, unsigned char& i_rotation) const;
+	//The same as Tetromino::rotate.
+	bool rotate(bool i_clockwise, std::array<Position, 4>& i_minos, unsigned char& i_rotation) const;
+
+	void visit(const std::array<Position, 4>& i_minos, unsigned char i_rotation, unsigned short i_parent, bool i_dropped, Move i_move);
+public:
+	MoveGenerator();
+
+	//The shortest path from where the last search started to the landing with these minos, into i_path so that its memory can be reused.
+	//0 if the tetromino can't get there.
+	bool get_path(const std::array<Position, 4>& i_minos, std::vector<Move>& i_path) const;
+
+	const std::array<Position, 4>& get_landing_minos(unsigned short i_index) const;
+
+	unsigned char get_landing_rotation(unsigned short i_index) const;
+
+	unsigned short get_landing_count() const;
+
+	void search(const Tetromino& i_tetromino, const Board& i_matrix);
+};
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+//One set of weights in the population, and how well it played.
+struct Candidate
+{
+	//The mean score of its games in the last generation, or -1 if it wasn't played yet.
+	double fitness;
+
+	BotWeights weights;
+};
+
+struct OptimizerSettings
+{
+	//How many games every candidate plays per generation. All the candidates of a generation play the same seeds.
+	unsigned game_count;
+	unsigned population_size;
+	unsigned seed;
+
+	//The chance that a child gets one weight moved, and by up to how much.
+	float mutation_rate;
+	float mutation_size;
+
+	//Where the population is saved after every generation. Empty for nowhere.
+	std::string checkpoint_path;
+
+	SimulationSettings simulation;
+};
+
+//A genetic algorithm over the bot weights, with the mean score of seeded headless games as the fitness.
+//Only the direction of the weights matters for which placement is chosen, so they're kept at a length of 1.
+//Every generation is played on the same seeds by every candidate, then the worst ones are replaced by children of the best ones.
+//The random numbers of a generation only depend on the seed and the generation, so a run resumed from a checkpoint goes on exactly like it would have.
+class Optimizer
+{
+	unsigned generation;
+
+	OptimizerSettings settings;
+
+	std::vector<Candidate> population;
+
+	ThreadPool& thread_pool;
+public:
+	//Starts from random weights and DEFAULT_BOT_WEIGHTS.
+	Optimizer(const OptimizerSettings& i_settings, ThreadPool& i_thread_pool);
+
+	//0 if there's no checkpoint or it doesn't fit the settings, in which case nothing changes.
+	bool load_checkpoint();
+	//Synced to a temporary file that then replaces the checkpoint, so a crash never leaves half of one.
+	bool save_checkpoint() const;
+
+	//After a generation, the candidates that were kept come first, best first, followed by the new children.
+	const std::vector<Candidate>& get_population() const;
+
+	unsigned get_generation() const;
+
+	//Plays every candidate, sorts them by fitness, breeds the next generation and saves the checkpoint.
+	void run_generation();
+};
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <array>
+
+//The most upcoming shapes the queue can hold.
+constexpr unsigned char MAX_PREVIEW = 8;
+
+//A ring buffer of the upcoming shapes, always kept full.
+//The preview and the bot only read from it, the randomizer is only called when a shape is taken out.
+class PieceQueue
+{
+	unsigned char count;
+	unsigned char front;
+
+	std::array<unsigned char, MAX_PREVIEW> shapes;
+public:
+	PieceQueue();
+
+	//0 is the next shape, 1 the one after it, and so on.
+	unsigned char get(unsigned char i_index) const;
+	unsigned char get_count() const;
+	//Takes out the next shape and adds a new one at the end.
+	unsigned char pop(Randomizer& i_randomizer);
+
+	//Fills the queue with i_count new shapes.
+	void reset(unsigned char i_count, Randomizer& i_randomizer);
+};
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+#include <array>
+#include <vector>
+
+//All the cells of the playfield, the clear effect and the preview of the upcoming shapes in a single sprite batch.
+//Only the cells that changed since the last update get rewritten and the whole thing is drawn with one draw call.
+class PlayfieldMesh : public sf::Drawable
+{
+	bool has_preview_box;
+	bool preview_visible;
+
+	unsigned char clear_cell_size;
+	unsigned char height;
+	unsigned char preview_count;
+	unsigned char width;
+
+	//What the preview shows, to only lay it out again when it changes.
+	std::array<unsigned char, MAX_PREVIEW> preview_shapes;
+
+	std::vector<bool> effect_rows;
+
+	std::vector<unsigned char> cells;
+	//Only kept as a member so that update doesn't allocate every frame.
+	std::vector<unsigned char> next_cells;
+
+	std::vector<sf::Color> colors;
+
+	//The region of the atlas every cell value is drawn with.
+	std::vector<sf::IntRect> cell_rects;
+
+	sf::IntRect preview_box_rect;
+	sf::IntRect white_rect;
+
+	SpriteBatch batch;
+
+	void draw(sf::RenderTarget& i_target, sf::RenderStates i_states) const override;
+	//Lays the quads out again for a matrix of a different size.
+	void resize(unsigned char i_width, unsigned char i_height);
+	void set_cell(unsigned short i_index, unsigned char i_cell);
+	//The 4 minos of the i_index-th upcoming shape, centered on i_center.
+	void set_preview_shape(unsigned char i_index, unsigned char i_shape, const sf::Vector2f& i_center, float i_cell_size);
+public:
+	PlayfieldMesh(const TextureAtlas& i_atlas, const std::vector<sf::Color>& i_colors, const std::vector<sf::IntRect>& i_cell_rects);
+
+	//The next shape goes in the preview box, and the ones after it go down i_queue_area, made as small as it takes for all of them to fit.
+	void update(GameSnapshot& i_snapshot, bool i_draw_active_piece, const sf::Vector2f& i_preview_position, const sf::Vector2f& i_preview_size, const sf::FloatRect& i_queue_area);
+};
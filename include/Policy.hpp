@@ -0,0 +1,77 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+enum class PolicyType : unsigned char
+{
+	//The best matrix after the current tetromino.
+	Greedy,
+	//The best matrix after the current and the next tetromino, like the autoplay bot.
+	Lookahead,
+	//Any placement, as a baseline.
+	Random
+};
+
+//Decides where every tetromino goes in a headless game. Every thread plays with its own policy.
+class Policy
+{
+protected:
+	BotWeights weights;
+
+	//Reused for every tetromino, so that choosing doesn't allocate.
+	MoveGenerator moves;
+
+	std::vector<Placement> placements;
+
+	PlacementBuffers buffers;
+
+	//Locks every placement into a copy of i_matrix and measures all of the copies at once into buffers.features.
+	void measure_placements(const std::vector<Placement>& i_placements, const Board& i_matrix, unsigned char i_shape, unsigned i_locked_rows);
+public:
+	Policy(const BotWeights& i_weights);
+	virtual ~Policy() = default;
+
+	//Always one of get_placements for the current tetromino, which is never empty since the tetromino could spawn.
+	virtual Placement choose(const GameState& i_game) = 0;
+
+	//Called before every game.
+	virtual void reset(unsigned i_seed);
+
+	//nullptr for the policies that don't remember any scores.
+	virtual const TranspositionTable* get_table() const;
+};
+
+class GreedyPolicy : public Policy
+{
+public:
+	GreedyPolicy(const BotWeights& i_weights);
+
+	Placement choose(const GameState& i_game) override;
+};
+
+class LookaheadPolicy : public Policy
+{
+	std::vector<Placement> next_placements;
+
+	TranspositionTable table;
+public:
+	LookaheadPolicy(const BotWeights& i_weights);
+
+	Placement choose(const GameState& i_game) override;
+
+	const TranspositionTable* get_table() const override;
+};
+
+class RandomPolicy : public Policy
+{
+	Xoshiro256 random_engine;
+public:
+	RandomPolicy(const BotWeights& i_weights);
+
+	Placement choose(const GameState& i_game) override;
+
+	void reset(unsigned i_seed) override;
+};
+
+std::unique_ptr<Policy> make_policy(PolicyType i_type, const BotWeights& i_weights);
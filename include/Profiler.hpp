@@ -0,0 +1,62 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <string>
+
+//How many frames are kept for the CSV dump, and how many of the most recent ones the overlay summarizes.
+constexpr unsigned short PROFILER_HISTORY = 3600;
+constexpr unsigned short PROFILER_OVERLAY_FRAMES = 120;
+
+//Everything measured during one rendered frame.
+struct FrameProfile
+{
+	unsigned short draw_calls;
+	//Fixed updates that ran late because the simulation thread was catching up.
+	unsigned short late_updates;
+	//How many fixed updates the simulation thread ran since the previous frame.
+	unsigned short updates;
+
+	unsigned heap_allocations;
+
+	std::chrono::microseconds frame_time;
+	//From when a key press was read from the window to the end of presenting the first frame that shows the piece moving. 0 if there wasn't one.
+	std::chrono::microseconds input_latency;
+	std::chrono::microseconds render_time;
+	std::chrono::microseconds update_time;
+};
+
+//Heap allocations made by the whole program since it started.
+unsigned long long get_heap_allocation_count();
+
+class Profiler
+{
+	bool started;
+
+	unsigned frame_count;
+
+	unsigned long long frame_start_allocations;
+
+	std::chrono::time_point<std::chrono::steady_clock> frame_start;
+	std::chrono::time_point<std::chrono::steady_clock> section_start;
+
+	FrameProfile current_frame;
+
+	std::array<FrameProfile, PROFILER_HISTORY> history;
+public:
+	Profiler();
+
+	bool save_csv(const std::string& i_path) const;
+
+	//Min/avg/p99 frame time, update and render time, input latency, draw calls, allocations and catch-up updates of the recent frames.
+	std::string get_overlay_text() const;
+
+	//Finishes the previous frame and starts measuring the next one.
+	void begin_frame();
+	void begin_section();
+	void count_draw_call();
+	void end_render();
+	void set_input_latency(const std::chrono::microseconds& i_latency);
+	//The updates run on another thread, so they're measured there and added to the frame that shows them.
+	void add_updates(unsigned short i_updates, unsigned short i_late_updates, const std::chrono::microseconds& i_time);
+};
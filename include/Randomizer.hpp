@@ -0,0 +1,91 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <memory>
+
+//xoshiro256**. Unlike std::default_random_engine, it gives the same numbers with every compiler, so seeded games replay everywhere.
+class Xoshiro256
+{
+	std::array<std::uint64_t, 4> state;
+public:
+	using result_type = std::uint64_t;
+
+	Xoshiro256(std::uint64_t i_seed);
+
+	//A number from 0 to i_bound - 1, without the bias of using %.
+	unsigned get_below(unsigned i_bound);
+
+	std::uint64_t operator()();
+
+	void seed(std::uint64_t i_seed);
+
+	static constexpr std::uint64_t min()
+	{
+		return 0;
+	}
+
+	static constexpr std::uint64_t max()
+	{
+		return UINT64_MAX;
+	}
+};
+
+enum class RandomizerType : unsigned char
+{
+	//Every shape is equally likely every time, which is how the game always worked.
+	Uniform,
+	//Every shape once, shuffled (7-bag).
+	Bag,
+	//Every shape twice, shuffled (14-bag).
+	DoubleBag,
+	//Rerolls shapes that were among the last 4, up to 6 times (TGM).
+	History
+};
+
+//Decides which shape comes next.
+class Randomizer
+{
+protected:
+	unsigned char shapes;
+
+	Xoshiro256 random_engine;
+public:
+	Randomizer(unsigned char i_shapes, unsigned i_seed);
+	virtual ~Randomizer() = default;
+
+	virtual unsigned char next() = 0;
+};
+
+class UniformRandomizer : public Randomizer
+{
+public:
+	UniformRandomizer(unsigned char i_shapes, unsigned i_seed);
+
+	unsigned char next() override;
+};
+
+class BagRandomizer : public Randomizer
+{
+	unsigned char bag_size;
+	unsigned char next_index;
+
+	std::array<unsigned char, 14> bag;
+public:
+	BagRandomizer(unsigned char i_shapes, unsigned char i_copies, unsigned i_seed);
+
+	unsigned char next() override;
+};
+
+class HistoryRandomizer : public Randomizer
+{
+	unsigned char oldest_index;
+
+	std::array<unsigned char, 4> history;
+public:
+	HistoryRandomizer(unsigned char i_shapes, unsigned i_seed);
+
+	unsigned char next() override;
+};
+
+std::unique_ptr<Randomizer> make_randomizer(RandomizerType i_type, unsigned char i_shapes, unsigned i_seed);
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+//A key event and the fixed update it happened in.
+struct ReplayEvent
+{
+	unsigned frame;
+
+	InputEvent event;
+};
+
+//Everything needed to play a game again exactly the same way.
+struct Replay
+{
+	bool advanced_mode;
+
+	unsigned char board_height;
+	unsigned char board_width;
+	unsigned char soft_drop_factor;
+
+	unsigned arr;
+	unsigned das;
+	unsigned final_lines;
+	unsigned final_score;
+	unsigned seed;
+
+	RandomizerType randomizer_type;
+
+	//The InputFrame::events of every fixed update that had any, in order.
+	std::vector<ReplayEvent> events;
+
+	//The InputFrame::keys of every fixed update, in order.
+	std::vector<unsigned char> inputs;
+};
+
+//The same for the same recording, and almost surely different for any other. It's the hash of the file save_replay writes.
+unsigned long long hash_replay(const Replay& i_replay);
+
+bool load_replay(const std::string& i_path, Replay& i_replay);
+//Adds the input of the next fixed update.
+void record_replay_frame(const InputFrame& i_input, Replay& i_replay);
+bool save_replay(const std::string& i_path, const Replay& i_replay);
+
+//The input of one fixed update. i_next_event is where the events of this update start, and it's moved past them.
+InputFrame get_replay_frame(const Replay& i_replay, std::size_t i_frame, std::size_t& i_next_event);
+
+//Runs every frame of the replay as fast as possible, without waiting for FRAME_DURATION.
+void simulate_replay(const Replay& i_replay, GameState& i_game);
@@ -0,0 +1,129 @@
+#pragma once
+
+#include <array>
+
+//Everything we need to turn a tetromino from one rotation state in one direction.
+struct Rotation
+{
+	//How much every mino moves when the tetromino turns, before the wall kick.
+	std::array<Position, 4> minos;
+
+	std::array<Position, 5> wall_kicks;
+};
+
+//Turning the minos the same way Tetromino::rotate used to: around the first mino, or around the center of the I shape.
+//The I shape is done in doubled coordinates so that its half-cell center stays an integer.
+constexpr std::array<Position, 4> turn_minos(unsigned char i_shape, unsigned char i_rotation, bool i_clockwise, const std::array<Position, 4>& i_minos)
+{
+	std::array<Position, 4> output_minos = i_minos;
+
+	if (0 == i_shape)
+	{
+		int center_x = i_minos[1].x + i_minos[2].x;
+		int center_y = i_minos[1].y + i_minos[2].y;
+
+		switch (i_rotation)
+		{
+			case 0:
+			{
+				center_y++;
+
+				break;
+			}
+			case 1:
+			{
+				center_x--;
+
+				break;
+			}
+			case 2:
+			{
+				center_y--;
+
+				break;
+			}
+			case 3:
+			{
+				center_x++;
+			}
+		}
+
+		for (unsigned char a = 0; a < 4; a++)
+		{
+			int x = 2 * i_minos[a].x - center_x;
+			int y = 2 * i_minos[a].y - center_y;
+
+			if (0 == i_clockwise)
+			{
+				output_minos[a].x = static_cast<signed char>((center_x + y) / 2);
+				output_minos[a].y = static_cast<signed char>((center_y - x) / 2);
+			}
+			else
+			{
+				output_minos[a].x = static_cast<signed char>((center_x - y) / 2);
+				output_minos[a].y = static_cast<signed char>((center_y + x) / 2);
+			}
+		}
+	}
+	else
+	{
+		for (unsigned char a = 1; a < 4; a++)
+		{
+			signed char x = i_minos[a].x - i_minos[0].x;
+			signed char y = i_minos[a].y - i_minos[0].y;
+
+			if (0 == i_clockwise)
+			{
+				output_minos[a].x = y + i_minos[0].x;
+				output_minos[a].y = i_minos[0].y - x;
+			}
+			else
+			{
+				output_minos[a].x = i_minos[0].x - y;
+				output_minos[a].y = x + i_minos[0].y;
+			}
+		}
+	}
+
+	return output_minos;
+}
+
+//[shape][current rotation][0 = counterclockwise, 1 = clockwise]
+//The O shape never turns, so its entries stay empty.
+constexpr std::array<std::array<std::array<Rotation, 2>, 4>, 7> generate_rotation_table()
+{
+	std::array<std::array<std::array<Rotation, 2>, 4>, 7> output_table = {};
+
+	for (unsigned char a = 0; a < 7; a++)
+	{
+		if (3 == a)
+		{
+			continue;
+		}
+
+		std::array<Position, 4> minos = TETROMINOES[a];
+
+		for (unsigned char b = 0; b < 4; b++)
+		{
+			for (unsigned char c = 0; c < 2; c++)
+			{
+				std::array<Position, 4> turned_minos = turn_minos(a, b, 1 == c, minos);
+
+				for (unsigned char d = 0; d < 4; d++)
+				{
+					output_table[a][b][c].minos[d].x = turned_minos[d].x - minos[d].x;
+					output_table[a][b][c].minos[d].y = turned_minos[d].y - minos[d].y;
+				}
+
+				output_table[a][b][c].wall_kicks = get_wall_kick_data(0 == a, b, 0 == c ? (3 + b) % 4 : (1 + b) % 4);
+			}
+
+			//The minos of the next rotation state.
+			minos = turn_minos(a, b, 1, minos);
+		}
+	}
+
+	return output_table;
+}
+
+constexpr std::array<std::array<std::array<Rotation, 2>, 4>, 7> ROTATION_TABLE = generate_rotation_table();
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <array>
+#include <mutex>
+#include <string>
+#include <vector>
+
+//Beginner and advanced games are ranked separately.
+constexpr unsigned char SCORE_MODE_COUNT = 2;
+//How many of the best games of every mode are kept.
+constexpr unsigned char SCORE_TABLE_SIZE = 10;
+
+//One finished game.
+struct ScoreRecord
+{
+	unsigned char mode;
+
+	//In milliseconds of play.
+	unsigned duration;
+	unsigned level;
+	unsigned lines;
+	unsigned score;
+
+	//hash_replay of the game's recording, 0 if there wasn't one.
+	unsigned long long replay_hash;
+	//When the game ended, in seconds since 1970.
+	unsigned long long time;
+};
+
+//Every finished game, kept as a binary log that games are only ever appended to. The tables of the best games are only a view of it.
+//Every record has a checksum, so a record torn by a power cut is skipped instead of breaking the rest.
+//The file is only rewritten whole by compaction, which drops the damaged records and keeps every other one. It goes into a temporary file that is synced and then renamed over the log.
+//All the writing happens on the IoWorker. The tables are updated right away, so they can be read without waiting for the disk.
+class ScoreLog
+{
+	//Whether the file is missing records or has damaged ones, so that the next write compacts it instead of appending. Only the worker touches it after loading.
+	bool needs_compaction;
+
+	//The best games of every mode, best first.
+	std::array<std::vector<ScoreRecord>, SCORE_MODE_COUNT> tables;
+
+	//Every game of the log in the order they were added, including the ones that couldn't be written yet. Only the worker touches it after loading.
+	std::vector<ScoreRecord> records;
+
+	mutable std::mutex mutex;
+
+	std::string path;
+
+	IoWorker& io_worker;
+
+	void append(const ScoreRecord& i_record);
+	void compact();
+public:
+	ScoreLog(const std::string& i_path, IoWorker& i_io_worker);
+	ScoreLog(const ScoreLog&) = delete;
+	//Waits for the worker, since its tasks use the log.
+	~ScoreLog();
+
+	ScoreLog& operator=(const ScoreLog&) = delete;
+
+	//0 if there's no log yet. A damaged log is loaded as far as it can be, then compacted.
+	bool load();
+
+	//Into i_table, so that its memory can be reused.
+	void get_table(unsigned char i_mode, std::vector<ScoreRecord>& i_table) const;
+
+	void add(const ScoreRecord& i_record);
+};
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <vector>
+
+//How every game of a headless batch is played.
+struct SimulationSettings
+{
+	bool advanced_mode;
+
+	unsigned char board_height;
+	unsigned char board_width;
+
+	//Games that place this many tetrominos stop there, since a good policy can play for a very long time. 0 for no limit.
+	unsigned max_pieces;
+	//How many frames every placement counts as, for the play time and the rising floor.
+	unsigned piece_frames;
+
+	BotWeights weights;
+
+	PolicyType policy_type;
+
+	RandomizerType randomizer_type;
+};
+
+//How one game ended.
+struct GameResult
+{
+	unsigned lines;
+	unsigned pieces;
+	unsigned score;
+
+	//How many of the matrices the policy measured were already in its transposition table, and how many weren't.
+	unsigned long long table_hits;
+	unsigned long long table_misses;
+};
+
+//Plays one game from the reset to the end, placing every tetromino right away instead of moving it there frame by frame.
+GameResult simulate_game(const SimulationSettings& i_settings, unsigned i_seed, Policy& i_policy, GameState& i_game);
+
+//Plays i_game_count games on the pool, with the seeds i_first_seed, i_first_seed + 1 and so on.
+//Every game is played on one thread, so the results are in the order of the seeds and don't depend on the number of threads.
+std::vector<GameResult> simulate_games(const SimulationSettings& i_settings, unsigned i_first_seed, unsigned i_game_count, ThreadPool& i_thread_pool);
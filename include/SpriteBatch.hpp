@@ -0,0 +1,25 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+
+//Quads that all sample the same texture, drawn with a single draw call.
+//Every quad keeps its index, so the ones that didn't change never have to be written again.
+class SpriteBatch : public sf::Drawable
+{
+	const sf::Texture* texture;
+
+	sf::VertexArray vertices;
+
+	void draw(sf::RenderTarget& i_target, sf::RenderStates i_states) const override;
+public:
+	SpriteBatch();
+
+	unsigned short get_quad_count() const;
+
+	void hide_quad(unsigned short i_index);
+	//Every quad is hidden after resizing.
+	void resize(unsigned short i_quad_count);
+	void set_quad(unsigned short i_index, const sf::FloatRect& i_position, const sf::IntRect& i_texture_rect, const sf::Color& i_color);
+	void set_quad_color(unsigned short i_index, const sf::Color& i_color);
+	void set_texture(const sf::Texture& i_texture);
+};
@@ -1,25 +1,36 @@
 #pragma once
 
+#include <array>
+
 class Tetromino
 {
+	//The ghost is only recalculated when the tetromino moves sideways, turns, or when the matrix changes.
+	bool ghost_valid;
+
 	unsigned char rotation;
 	unsigned char shape;
 
-	std::vector<Position> minos;
+	unsigned ghost_revision;
+
+	const Board* ghost_matrix;
+
+	std::array<Position, 4> ghost_minos;
+	std::array<Position, 4> minos;
 public:
-	Tetromino(unsigned char i_shape, const std::vector<std::vector<unsigned char>>& i_matrix);
+	Tetromino(unsigned char i_shape, const Board& i_matrix);
 
-	bool move_down(const std::vector<std::vector<unsigned char>>& i_matrix);
-	bool reset(unsigned char i_shape, const std::vector<std::vector<unsigned char>>& i_matrix);
+	bool move_down(const Board& i_matrix);
+	bool move_left(const Board& i_matrix);
+	bool move_right(const Board& i_matrix);
+	bool reset(unsigned char i_shape, const Board& i_matrix);
+	bool rotate(bool i_clockwise, const Board& i_matrix);
 
-	unsigned char get_shape();
+	unsigned char get_rotation() const;
+	unsigned char get_shape() const;
 
-	void hard_drop(const std::vector<std::vector<unsigned char>>& i_matrix);
-	void move_left(const std::vector<std::vector<unsigned char>>& i_matrix);
-	void move_right(const std::vector<std::vector<unsigned char>>& i_matrix);
-	void rotate(bool i_clockwise, const std::vector<std::vector<unsigned char>>& i_matrix);
-	void update_matrix(std::vector<std::vector<unsigned char>>& i_matrix);
+	void hard_drop(const Board& i_matrix);
+	void update_matrix(Board& i_matrix) const;
 
-	std::vector<Position> get_ghost_minos(const std::vector<std::vector<unsigned char>>& i_matrix);
-	std::vector<Position> get_minos();
-};
\ No newline at end of file
+	const std::array<Position, 4>& get_ghost_minos(const Board& i_matrix);
+	const std::array<Position, 4>& get_minos() const;
+};
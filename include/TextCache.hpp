@@ -0,0 +1,51 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+//Keeps the glyph quads of every text we draw, keyed by the string and where it's drawn, so a text is only built again when the string changes.
+//Texts that change (like the score) are drawn one at a time and forgotten once a frame goes by without them.
+//Labels that never change are queued and drawn together in a single vertex array, which is kept for every set of labels a frame has had, so switching screens doesn't build anything.
+class TextCache
+{
+	struct Entry
+	{
+		//The last frame it was drawn in.
+		unsigned frame;
+
+		sf::VertexArray vertices;
+	};
+
+	unsigned frame;
+
+	//Owned by whoever loaded it, and has to outlive the cache.
+	const sf::Font* font;
+
+	//The key of the labels queued this frame, made as they're queued.
+	std::string label_key;
+	//Reused for every lookup, so that it doesn't allocate.
+	std::string text_key;
+
+	//The labels queued this frame, in the order they were queued.
+	std::vector<std::pair<sf::Vector2<unsigned short>, std::string>> labels;
+
+	std::unordered_map<std::string, Entry> entries;
+	std::unordered_map<std::string, sf::VertexArray> label_arrays;
+
+	//Adds the quads of the text to i_vertices.
+	void build(unsigned short i_x, unsigned short i_y, const std::string& i_text, sf::VertexArray& i_vertices) const;
+public:
+	TextCache();
+
+	void add_label(unsigned short i_x, unsigned short i_y, const std::string& i_text);
+	void draw(unsigned short i_x, unsigned short i_y, const std::string& i_text, sf::RenderTarget& i_target);
+	//Draws the labels queued this frame in one draw call.
+	void draw_labels(sf::RenderTarget& i_target);
+	//Forgets the texts that weren't drawn this frame.
+	void end_frame();
+	//Nothing is drawn until there's a font. Changing it rebuilds every text.
+	void set_font(const sf::Font& i_font);
+};
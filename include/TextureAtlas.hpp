@@ -0,0 +1,40 @@
+#pragma once
+
+#include <SFML/Graphics.hpp>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+//Every image the game draws, packed into a single texture so that a whole scene can be drawn without switching textures.
+class TextureAtlas
+{
+	struct Entry
+	{
+		const sf::Image* image;
+
+		sf::IntRect source;
+
+		std::string name;
+	};
+
+	//The images waiting for the next build. They have to stay alive until then.
+	std::vector<Entry> entries;
+
+	std::unordered_map<std::string, sf::IntRect> regions;
+
+	sf::Texture texture;
+public:
+	void add_image(const std::string& i_name, const sf::Image& i_image);
+	//Splits a horizontal strip into square tiles, named i_name followed by their index.
+	void add_tiles(const std::string& i_name, const sf::Image& i_image);
+
+	//Packs everything that was added in rows, tallest first, and uploads the result.
+	//There's always a "white" region, for the quads that only have a color.
+	bool build();
+	bool has_region(const std::string& i_name) const;
+
+	//The white region if there's no region with that name.
+	sf::IntRect get_region(const std::string& i_name) const;
+
+	const sf::Texture& get_texture() const;
+};
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+//Every worker has its own queue. It takes tasks from the back of it and, when it runs out, steals from the front of the others.
+class ThreadPool
+{
+	struct Worker
+	{
+		std::mutex mutex;
+
+		std::deque<std::function<void()>> tasks;
+	};
+
+	bool stopping;
+
+	//Tasks that were pushed but not finished yet, and tasks that are still waiting in a queue.
+	std::atomic<unsigned> pending_tasks;
+	std::atomic<unsigned> queued_tasks;
+
+	std::atomic<unsigned> next_worker;
+
+	std::condition_variable wake_condition;
+
+	std::mutex wake_mutex;
+
+	std::vector<std::thread> threads;
+
+	std::vector<std::unique_ptr<Worker>> workers;
+
+	std::function<void()> pop_task(unsigned i_worker);
+
+	void work(unsigned i_worker);
+public:
+	ThreadPool(unsigned i_thread_count);
+	~ThreadPool();
+
+	unsigned get_thread_count() const;
+	//Which worker the calling thread is, or get_thread_count() for a thread outside the pool that helps while it waits.
+	//So anything kept per thread needs 1 more than get_thread_count(), and only one thread outside the pool can wait at a time.
+	unsigned get_thread_index() const;
+
+	void push(std::function<void()> i_task);
+	//The calling thread helps with the tasks until all of them are finished.
+	void wait();
+};
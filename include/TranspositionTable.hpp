@@ -0,0 +1,45 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+
+//How many buckets the bot's tables have, as a power of 2. A search measures a few hundred matrices, so this holds several of them.
+constexpr unsigned char BOT_TABLE_BITS = 12;
+
+//Remembers the scores of matrices the bot already measured, keyed by their hash, so that a matrix reached again isn't measured again.
+//Any number of threads can use it at once without locks. Every slot keeps its key xored with its data, so a slot that two threads wrote at the same time no longer matches either key and is just a miss.
+//Every bucket has 2 slots. The first keeps what the current search stored in it, the second is always replaced, and entries from older searches give way to new ones in both.
+class TranspositionTable
+{
+	struct Slot
+	{
+		//The key xored with the data.
+		std::atomic<unsigned long long> check;
+		//The score in the low 32 bits and the search it's from above them.
+		std::atomic<unsigned long long> data;
+	};
+
+	unsigned char search;
+
+	unsigned long long mask;
+
+	std::atomic<unsigned long long> hits;
+	std::atomic<unsigned long long> misses;
+
+	std::unique_ptr<Slot[]> slots;
+public:
+	TranspositionTable(unsigned char i_size_bits);
+
+	//Only between searches, when nothing else uses the table.
+	void clear();
+	void count_lookups(unsigned long long i_hits, unsigned long long i_misses);
+	//Called before every search, so that the entries of the previous ones can be replaced first. Only between searches.
+	void new_search();
+	//The key can't be 0, which marks an empty slot.
+	void store(unsigned long long i_key, float i_score);
+
+	bool find(unsigned long long i_key, float& i_score) const;
+
+	unsigned long long get_hits() const;
+	unsigned long long get_misses() const;
+};
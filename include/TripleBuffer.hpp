@@ -0,0 +1,61 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+
+//Hands values from one writer thread to one reader thread without locks or waiting.
+//The writer always has a slot to fill, the reader always has the latest complete value, and the slot in the middle is swapped between them.
+template <typename T>
+class TripleBuffer
+{
+	//Set on the middle index when the writer published into it and the reader hasn't taken it yet.
+	static constexpr unsigned char FRESH = 4;
+	static constexpr unsigned char INDEX_MASK = 3;
+
+	//Only touched by the writer.
+	unsigned char back;
+	//Only touched by the reader.
+	unsigned char front;
+
+	std::atomic<unsigned char> middle;
+
+	std::array<T, 3> slots;
+public:
+	TripleBuffer() :
+		back(0),
+		front(1),
+		middle(2)
+	{
+	}
+
+	//Takes the latest published value, if there's a new one. Returns 0 if the front slot didn't change.
+	bool read()
+	{
+		if (0 == (FRESH & middle.load(std::memory_order_relaxed)))
+		{
+			return 0;
+		}
+
+		front = INDEX_MASK & middle.exchange(front, std::memory_order_acq_rel);
+
+		return 1;
+	}
+
+	//The slot the writer fills. It still holds whatever was written to it a few publishes ago.
+	T& get_back()
+	{
+		return slots[back];
+	}
+
+	//The slot the reader uses until the next read.
+	T& get_front()
+	{
+		return slots[front];
+	}
+
+	//Makes the back slot the latest value. An older value the reader didn't take is dropped.
+	void publish()
+	{
+		back = INDEX_MASK & middle.exchange(FRESH | back, std::memory_order_acq_rel);
+	}
+};
@@ -0,0 +1,317 @@
+#include <SFML/Graphics.hpp>
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iterator>
+#include <sstream>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#include "MappedFile.hpp"
+#include "ThreadPool.hpp"
+#include "AssetLoader.hpp"
+
+//Used when there's no manifest file, the same as assets/manifest.txt.
+constexpr const char* DEFAULT_MANIFEST =
+	"background = assets/Images/background.png | Resources/Images/background.png\n"
+	"frame = Resources/Images/frame.png | Project/img/frame.png\n"
+	"scorebar = Resources/Images/Score bar.png | Project/img/Score bar.png\n"
+	"nextbox = Resources/Images/Next tetriminos shown.png | Project/img/Next tetriminos shown.png\n"
+	"tiles = assets/Images/tiles.png | Resources/Images/tiles.png\n"
+	"font = assets/Images/Font.ttf | Resources/Images/Font.ttf | /mingw64/share/fonts/TTF/DejaVuSans.ttf | C:/Windows/Fonts/arial.ttf | C:/Windows/Fonts/segoeui.ttf\n";
+
+//The pack starts with the magic, the version and the number of assets.
+//Then every asset has: 1 byte (1 = font), the name length and the name, then its offset and size as 64 bit numbers. The bytes of the assets follow.
+//All the numbers are little endian.
+constexpr std::array<char, 4> PACK_MAGIC = {'T', 'P', 'A', 'K'};
+constexpr unsigned char PACK_VERSION = 1;
+
+static std::string trim(const std::string& i_text)
+{
+	std::size_t start = i_text.find_first_not_of(" \t\r");
+
+	if (std::string::npos == start)
+	{
+		return "";
+	}
+
+	return i_text.substr(start, 1 + i_text.find_last_not_of(" \t\r") - start);
+}
+
+static bool is_font_path(const std::string& i_path)
+{
+	std::string extension = std::filesystem::path(i_path).extension().string();
+
+	return ".ttf" == extension || ".otf" == extension;
+}
+
+static void write_u64(std::vector<unsigned char>& i_bytes, std::uint64_t i_value)
+{
+	for (unsigned char a = 0; a < 8; a++)
+	{
+		i_bytes.push_back(static_cast<unsigned char>(i_value >> (8 * a)));
+	}
+}
+
+static std::uint64_t read_u64(const unsigned char* i_bytes)
+{
+	std::uint64_t value = 0;
+
+	for (unsigned char a = 0; a < 8; a++)
+	{
+		value |= static_cast<std::uint64_t>(i_bytes[a]) << (8 * a);
+	}
+
+	return value;
+}
+
+AssetLoader::AssetLoader() :
+	use_pack(0)
+{
+}
+
+const AssetLoader::Asset* AssetLoader::find(const std::string& i_name) const
+{
+	for (const Asset& asset : assets)
+	{
+		if (asset.name == i_name)
+		{
+			return &asset;
+		}
+	}
+
+	return nullptr;
+}
+
+void AssetLoader::decode(Asset& i_asset)
+{
+	if (1 == use_pack)
+	{
+		const unsigned char* bytes = pack.get_data() + i_asset.pack_offset;
+
+		if (1 == i_asset.is_font)
+		{
+			//The font keeps reading from the mapped pack, which stays open as long as we do.
+			i_asset.loaded = i_asset.font.openFromMemory(bytes, i_asset.pack_size);
+		}
+		else
+		{
+			i_asset.loaded = i_asset.image.loadFromMemory(bytes, i_asset.pack_size);
+		}
+	}
+	else if (0 == i_asset.path.empty())
+	{
+		if (1 == i_asset.is_font)
+		{
+			i_asset.loaded = i_asset.font.openFromFile(i_asset.path);
+		}
+		else
+		{
+			i_asset.loaded = i_asset.image.loadFromFile(i_asset.path);
+		}
+	}
+}
+
+void AssetLoader::parse_manifest(const std::string& i_text)
+{
+	std::istringstream lines(i_text);
+
+	std::string line;
+
+	use_pack = 0;
+
+	assets.clear();
+
+	while (std::getline(lines, line))
+	{
+		std::size_t equals = line.find('=');
+
+		if (0 == trim(line).rfind('#', 0) || std::string::npos == equals)
+		{
+			continue;
+		}
+
+		Asset asset = {};
+		asset.name = trim(line.substr(0, equals));
+
+		std::istringstream candidates(line.substr(1 + equals));
+
+		std::string candidate;
+
+		//We only check that the paths exist, so missing ones don't make SFML print errors.
+		while (std::getline(candidates, candidate, '|'))
+		{
+			std::error_code error;
+
+			candidate = trim(candidate);
+
+			if (0 == candidate.empty() && 1 == std::filesystem::is_regular_file(candidate, error))
+			{
+				asset.path = candidate;
+				asset.is_font = is_font_path(candidate);
+
+				break;
+			}
+		}
+
+		assets.push_back(asset);
+	}
+}
+
+bool AssetLoader::load_manifest(const std::string& i_path)
+{
+	std::ifstream file(i_path);
+
+	if (0 == file.is_open())
+	{
+		parse_manifest(DEFAULT_MANIFEST);
+
+		return 0;
+	}
+
+	parse_manifest(std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()));
+
+	return 1;
+}
+
+bool AssetLoader::open_pack(const std::string& i_path)
+{
+	if (0 == pack.open(i_path))
+	{
+		return 0;
+	}
+
+	const unsigned char* bytes = pack.get_data();
+
+	std::size_t offset = 2 + PACK_MAGIC.size();
+	std::size_t size = pack.get_size();
+
+	if (size < offset || 0 == std::equal(PACK_MAGIC.begin(), PACK_MAGIC.end(), bytes) || PACK_VERSION != bytes[PACK_MAGIC.size()])
+	{
+		pack.close();
+
+		return 0;
+	}
+
+	std::vector<Asset> pack_assets(bytes[1 + PACK_MAGIC.size()]);
+
+	for (Asset& asset : pack_assets)
+	{
+		if (size < 2 + offset || size < 2 + 16 + offset + bytes[1 + offset])
+		{
+			pack.close();
+
+			return 0;
+		}
+
+		asset.is_font = 1 == bytes[offset];
+		asset.loaded = 0;
+		asset.name.assign(reinterpret_cast<const char*>(bytes + 2 + offset), bytes[1 + offset]);
+
+		offset += 2 + asset.name.size();
+
+		asset.pack_offset = static_cast<std::size_t>(read_u64(bytes + offset));
+		asset.pack_size = static_cast<std::size_t>(read_u64(bytes + 8 + offset));
+
+		offset += 16;
+
+		if (size < asset.pack_offset || size - asset.pack_offset < asset.pack_size)
+		{
+			pack.close();
+
+			return 0;
+		}
+	}
+
+	assets = std::move(pack_assets);
+
+	use_pack = 1;
+
+	return 1;
+}
+
+bool AssetLoader::save_pack(const std::string& i_path) const
+{
+	std::vector<const Asset*> found_assets;
+
+	std::vector<std::vector<unsigned char>> contents;
+
+	std::size_t header_size = 2 + PACK_MAGIC.size();
+
+	for (const Asset& asset : assets)
+	{
+		std::ifstream file(asset.path, std::ios::binary);
+
+		if (1 == asset.path.empty() || 0 == file.is_open() || 255 < asset.name.size())
+		{
+			continue;
+		}
+
+		found_assets.push_back(&asset);
+
+		contents.emplace_back(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+
+		header_size += 2 + 16 + asset.name.size();
+	}
+
+	std::vector<unsigned char> bytes(PACK_MAGIC.begin(), PACK_MAGIC.end());
+
+	bytes.push_back(PACK_VERSION);
+	bytes.push_back(static_cast<unsigned char>(found_assets.size()));
+
+	std::size_t data_offset = header_size;
+
+	for (std::size_t a = 0; a < found_assets.size(); a++)
+	{
+		bytes.push_back(found_assets[a]->is_font);
+		bytes.push_back(static_cast<unsigned char>(found_assets[a]->name.size()));
+		bytes.insert(bytes.end(), found_assets[a]->name.begin(), found_assets[a]->name.end());
+
+		write_u64(bytes, data_offset);
+		write_u64(bytes, contents[a].size());
+
+		data_offset += contents[a].size();
+	}
+
+	for (const std::vector<unsigned char>& content : contents)
+	{
+		bytes.insert(bytes.end(), content.begin(), content.end());
+	}
+
+	std::ofstream file(i_path, std::ios::binary | std::ios::trunc);
+
+	file.write(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+
+	return file.good();
+}
+
+const sf::Font* AssetLoader::get_font(const std::string& i_name) const
+{
+	const Asset* asset = find(i_name);
+
+	return nullptr != asset && 1 == asset->loaded && 1 == asset->is_font ? &asset->font : nullptr;
+}
+
+const sf::Image* AssetLoader::get_image(const std::string& i_name) const
+{
+	const Asset* asset = find(i_name);
+
+	return nullptr != asset && 1 == asset->loaded && 0 == asset->is_font ? &asset->image : nullptr;
+}
+
+void AssetLoader::start_loading(ThreadPool& i_thread_pool)
+{
+	//Every asset is decoded on its own, so they can all be decoded at the same time.
+	for (Asset& asset : assets)
+	{
+		i_thread_pool.push([this, &asset]()
+		{
+			decode(asset);
+		});
+	}
+}
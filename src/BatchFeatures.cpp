@@ -0,0 +1,445 @@
+#include <algorithm>
+#include <array>
+#include <cstdlib>
+#include <iterator>
+#include <vector>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && 2 <= _M_IX86_FP)
+#include <emmintrin.h>
+#define BATCH_FEATURES_SSE2
+#endif
+
+#include "Global.hpp"
+#include "Board.hpp"
+#include "Tetromino.hpp"
+#include "Randomizer.hpp"
+#include "PieceQueue.hpp"
+#include "GameState.hpp"
+#include "ThreadPool.hpp"
+#include "MoveGenerator.hpp"
+#include "TranspositionTable.hpp"
+#include "Bot.hpp"
+#include "BatchFeatures.hpp"
+
+//A well can be at most as deep as the matrix is tall, which fits in this many bits.
+constexpr unsigned char WELL_HEIGHT_BITS = 6;
+
+//What the lanes past the last matrix read.
+constexpr std::array<unsigned char, MAX_ROWS> EMPTY_ROW_COLORS = {};
+constexpr std::array<unsigned, MAX_ROWS> EMPTY_ROWS = {};
+
+//Every lane is the row of one matrix. This is the fallback with a single lane, which measures one matrix at a time.
+struct ScalarLanes
+{
+	using Vector = unsigned;
+
+	static constexpr unsigned char COUNT = 1;
+
+	static Vector add(Vector i_a, Vector i_b)
+	{
+		return i_a + i_b;
+	}
+
+	static Vector and_not(Vector i_a, Vector i_b)
+	{
+		return i_a & ~i_b;
+	}
+
+	static Vector bit_and(Vector i_a, Vector i_b)
+	{
+		return i_a & i_b;
+	}
+
+	static Vector bit_or(Vector i_a, Vector i_b)
+	{
+		return i_a | i_b;
+	}
+
+	static Vector bit_xor(Vector i_a, Vector i_b)
+	{
+		return i_a ^ i_b;
+	}
+
+	//Every bit set in the lanes that are equal, none in the others.
+	static Vector equal(Vector i_a, Vector i_b)
+	{
+		return 0 - static_cast<unsigned>(i_a == i_b);
+	}
+
+	static bool is_any_set(Vector i_a)
+	{
+		return 0 != i_a;
+	}
+
+	//Element i_index of every lane's array.
+	template <typename T>
+	static Vector gather(const std::array<const T*, COUNT>& i_arrays, unsigned char i_index)
+	{
+		return i_arrays[0][i_index];
+	}
+
+	static Vector set(unsigned i_value)
+	{
+		return i_value;
+	}
+
+	static Vector shift_left(Vector i_a, int i_count)
+	{
+		return i_a << i_count;
+	}
+
+	static Vector shift_right(Vector i_a, int i_count)
+	{
+		return i_a >> i_count;
+	}
+
+	static void store(Vector i_a, unsigned* i_values)
+	{
+		*i_values = i_a;
+	}
+
+	static Vector sub(Vector i_a, Vector i_b)
+	{
+		return i_a - i_b;
+	}
+};
+
+#if defined(__AVX2__)
+struct Avx2Lanes
+{
+	using Vector = __m256i;
+
+	static constexpr unsigned char COUNT = 8;
+
+	static Vector add(Vector i_a, Vector i_b)
+	{
+		return _mm256_add_epi32(i_a, i_b);
+	}
+
+	static Vector and_not(Vector i_a, Vector i_b)
+	{
+		return _mm256_andnot_si256(i_b, i_a);
+	}
+
+	static Vector bit_and(Vector i_a, Vector i_b)
+	{
+		return _mm256_and_si256(i_a, i_b);
+	}
+
+	static Vector bit_or(Vector i_a, Vector i_b)
+	{
+		return _mm256_or_si256(i_a, i_b);
+	}
+
+	static Vector bit_xor(Vector i_a, Vector i_b)
+	{
+		return _mm256_xor_si256(i_a, i_b);
+	}
+
+	static Vector equal(Vector i_a, Vector i_b)
+	{
+		return _mm256_cmpeq_epi32(i_a, i_b);
+	}
+
+	static bool is_any_set(Vector i_a)
+	{
+		return 0 == _mm256_testz_si256(i_a, i_a);
+	}
+
+	template <typename T>
+	static Vector gather(const std::array<const T*, COUNT>& i_arrays, unsigned char i_index)
+	{
+		return _mm256_set_epi32(i_arrays[7][i_index], i_arrays[6][i_index], i_arrays[5][i_index], i_arrays[4][i_index], i_arrays[3][i_index], i_arrays[2][i_index], i_arrays[1][i_index], i_arrays[0][i_index]);
+	}
+
+	static Vector set(unsigned i_value)
+	{
+		return _mm256_set1_epi32(static_cast<int>(i_value));
+	}
+
+	static Vector shift_left(Vector i_a, int i_count)
+	{
+		return _mm256_sll_epi32(i_a, _mm_cvtsi32_si128(i_count));
+	}
+
+	static Vector shift_right(Vector i_a, int i_count)
+	{
+		return _mm256_srl_epi32(i_a, _mm_cvtsi32_si128(i_count));
+	}
+
+	static void store(Vector i_a, unsigned* i_values)
+	{
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(i_values), i_a);
+	}
+
+	static Vector sub(Vector i_a, Vector i_b)
+	{
+		return _mm256_sub_epi32(i_a, i_b);
+	}
+};
+
+using FeatureLanes = Avx2Lanes;
+#elif defined(BATCH_FEATURES_SSE2)
+struct Sse2Lanes
+{
+	using Vector = __m128i;
+
+	static constexpr unsigned char COUNT = 4;
+
+	static Vector add(Vector i_a, Vector i_b)
+	{
+		return _mm_add_epi32(i_a, i_b);
+	}
+
+	static Vector and_not(Vector i_a, Vector i_b)
+	{
+		return _mm_andnot_si128(i_b, i_a);
+	}
+
+	static Vector bit_and(Vector i_a, Vector i_b)
+	{
+		return _mm_and_si128(i_a, i_b);
+	}
+
+	static Vector bit_or(Vector i_a, Vector i_b)
+	{
+		return _mm_or_si128(i_a, i_b);
+	}
+
+	static Vector bit_xor(Vector i_a, Vector i_b)
+	{
+		return _mm_xor_si128(i_a, i_b);
+	}
+
+	static Vector equal(Vector i_a, Vector i_b)
+	{
+		return _mm_cmpeq_epi32(i_a, i_b);
+	}
+
+	static bool is_any_set(Vector i_a)
+	{
+		return 0xffff != _mm_movemask_epi8(_mm_cmpeq_epi32(i_a, _mm_setzero_si128()));
+	}
+
+	template <typename T>
+	static Vector gather(const std::array<const T*, COUNT>& i_arrays, unsigned char i_index)
+	{
+		return _mm_set_epi32(i_arrays[3][i_index], i_arrays[2][i_index], i_arrays[1][i_index], i_arrays[0][i_index]);
+	}
+
+	static Vector set(unsigned i_value)
+	{
+		return _mm_set1_epi32(static_cast<int>(i_value));
+	}
+
+	static Vector shift_left(Vector i_a, int i_count)
+	{
+		return _mm_sll_epi32(i_a, _mm_cvtsi32_si128(i_count));
+	}
+
+	static Vector shift_right(Vector i_a, int i_count)
+	{
+		return _mm_srl_epi32(i_a, _mm_cvtsi32_si128(i_count));
+	}
+
+	static void store(Vector i_a, unsigned* i_values)
+	{
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(i_values), i_a);
+	}
+
+	static Vector sub(Vector i_a, Vector i_b)
+	{
+		return _mm_sub_epi32(i_a, i_b);
+	}
+};
+
+using FeatureLanes = Sse2Lanes;
+#else
+using FeatureLanes = ScalarLanes;
+#endif
+
+//The number of set bits in every lane, without a popcount instruction, which SSE2 doesn't have.
+template <typename Lanes>
+static typename Lanes::Vector count_lane_bits(typename Lanes::Vector i_bits)
+{
+	typename Lanes::Vector bits = Lanes::sub(i_bits, Lanes::bit_and(Lanes::shift_right(i_bits, 1), Lanes::set(0x55555555)));
+
+	bits = Lanes::add(Lanes::bit_and(bits, Lanes::set(0x33333333)), Lanes::bit_and(Lanes::shift_right(bits, 2), Lanes::set(0x33333333)));
+	bits = Lanes::bit_and(Lanes::add(bits, Lanes::shift_right(bits, 4)), Lanes::set(0x0f0f0f0f));
+	bits = Lanes::add(bits, Lanes::shift_right(bits, 8));
+	bits = Lanes::add(bits, Lanes::shift_right(bits, 16));
+
+	return Lanes::bit_and(bits, Lanes::set(63));
+}
+
+//get_features of Lanes::COUNT matrices starting from i_first, in one pass from the top of the highest stack down.
+//The lanes past the last matrix get empty rows, and what comes out of them is thrown away.
+template <typename Lanes>
+static void get_lane_features(const std::vector<Board>& i_matrices, const std::vector<unsigned>& i_line_points, std::size_t i_first, unsigned i_locked_rows, std::vector<BotFeatures>& i_features)
+{
+	using Vector = typename Lanes::Vector;
+
+	unsigned char plane_count = 1;
+	unsigned char stack_height = 0;
+
+	const Board& first_matrix = i_matrices[i_first];
+
+	unsigned char height = first_matrix.get_height();
+	unsigned char width = first_matrix.get_width();
+
+	std::size_t lane_count = std::min<std::size_t>(Lanes::COUNT, i_matrices.size() - i_first);
+
+	std::array<unsigned, Lanes::COUNT> aggregate_heights = {};
+	std::array<unsigned, Lanes::COUNT> bumpiness = {};
+
+	std::array<const unsigned char*, Lanes::COUNT> row_colors;
+	std::array<const unsigned*, Lanes::COUNT> rows;
+
+	//The height of the well every column is in, one bit of it per plane, so that all of the wells go one deeper at once.
+	//A plain array, since std::array would drop the alignment of the SIMD types.
+	Vector well_planes[WELL_HEIGHT_BITS];
+
+	Vector first_column = Lanes::set(1);
+	Vector full_row = Lanes::set(first_matrix.get_full_row());
+	Vector inner_columns = Lanes::set(first_matrix.get_full_row() >> 1);
+	Vector last_column = Lanes::set(1u << (width - 1));
+	Vector mixed_row_color = Lanes::set(MIXED_ROW_COLOR);
+	Vector zero = Lanes::set(0);
+
+	Vector column_transitions = zero;
+	Vector covered_columns = zero;
+	Vector floor_holes = zero;
+	Vector holes = zero;
+	Vector mono_cells = zero;
+	Vector previous_row = zero;
+	Vector previous_wells = zero;
+	Vector row_transitions = zero;
+	Vector row_well_depth = zero;
+	Vector well_depth = zero;
+
+	std::fill(std::begin(well_planes), std::end(well_planes), zero);
+
+	while (plane_count < WELL_HEIGHT_BITS && (1u << plane_count) <= height)
+	{
+		plane_count++;
+	}
+
+	row_colors.fill(EMPTY_ROW_COLORS.data());
+	rows.fill(EMPTY_ROWS.data());
+
+	//The column heights are already kept by the matrices, so they don't need lanes.
+	for (std::size_t a = 0; a < lane_count; a++)
+	{
+		const Board& matrix = i_matrices[i_first + a];
+
+		const std::array<unsigned char, MAX_COLUMNS>& column_heights = matrix.get_column_heights();
+
+		row_colors[a] = matrix.get_row_colors().data();
+		rows[a] = matrix.get_rows().data();
+
+		for (unsigned char b = 0; b < width; b++)
+		{
+			aggregate_heights[a] += column_heights[b];
+
+			if (0 < b)
+			{
+				bumpiness[a] += std::abs(column_heights[b] - column_heights[b - 1]);
+			}
+
+			stack_height = std::max(stack_height, column_heights[b]);
+		}
+	}
+
+	for (unsigned char a = height - stack_height; a < height; a++)
+	{
+		Vector row = Lanes::gather(rows, a);
+		Vector row_holes = count_lane_bits<Lanes>(Lanes::and_not(covered_columns, row));
+		Vector empty_row = Lanes::equal(row, zero);
+
+		holes = Lanes::add(holes, row_holes);
+
+		if (a + 1 + i_locked_rows == height)
+		{
+			floor_holes = row_holes;
+		}
+
+		covered_columns = Lanes::bit_or(covered_columns, row);
+
+		column_transitions = Lanes::add(column_transitions, count_lane_bits<Lanes>(Lanes::bit_xor(previous_row, row)));
+
+		previous_row = row;
+
+		//A lane that is equal is all ones, which is -1, so subtracting it adds 1 for every wall next to an empty cell.
+		Vector transitions = count_lane_bits<Lanes>(Lanes::bit_and(Lanes::bit_xor(row, Lanes::shift_right(row, 1)), inner_columns));
+
+		transitions = Lanes::sub(transitions, Lanes::equal(Lanes::bit_and(row, first_column), zero));
+		transitions = Lanes::sub(transitions, Lanes::equal(Lanes::bit_and(row, last_column), zero));
+
+		row_transitions = Lanes::add(row_transitions, Lanes::and_not(transitions, empty_row));
+
+		//Empty rows have no cells to count, and full rows are left out.
+		Vector mono_row = Lanes::and_not(count_lane_bits<Lanes>(row), Lanes::equal(Lanes::gather(row_colors, a), mixed_row_color));
+
+		mono_cells = Lanes::add(mono_cells, Lanes::and_not(mono_row, Lanes::equal(row, full_row)));
+
+		Vector wells = Lanes::bit_and(Lanes::and_not(full_row, row), Lanes::bit_and(Lanes::bit_or(first_column, Lanes::shift_left(row, 1)), Lanes::bit_or(last_column, Lanes::shift_right(row, 1))));
+
+		Vector carry = wells;
+		Vector continuing = Lanes::bit_and(wells, previous_wells);
+		Vector ended = Lanes::and_not(previous_wells, wells);
+
+		//Every well cell counts 1 more than the one above it, so a row adds up to the row above plus its well cells, minus the heights of the wells that ended.
+		//Wells rarely end, so the heights are only added up when one does.
+		if (1 == Lanes::is_any_set(ended))
+		{
+			for (unsigned char b = 0; b < plane_count; b++)
+			{
+				row_well_depth = Lanes::sub(row_well_depth, Lanes::shift_left(count_lane_bits<Lanes>(Lanes::bit_and(well_planes[b], ended)), b));
+			}
+		}
+
+		row_well_depth = Lanes::add(row_well_depth, count_lane_bits<Lanes>(wells));
+
+		well_depth = Lanes::add(well_depth, row_well_depth);
+
+		//Adds 1 to the wells that go on from the row above and starts the new ones at 1, like adding with a carry.
+		for (unsigned char b = 0; b < plane_count; b++)
+		{
+			Vector kept = Lanes::bit_and(well_planes[b], continuing);
+
+			well_planes[b] = Lanes::bit_xor(kept, carry);
+
+			carry = Lanes::bit_and(kept, carry);
+		}
+
+		previous_wells = wells;
+	}
+
+	column_transitions = Lanes::add(column_transitions, count_lane_bits<Lanes>(Lanes::and_not(full_row, previous_row)));
+
+	std::array<std::array<unsigned, Lanes::COUNT>, 6> lane_features;
+
+	Lanes::store(column_transitions, lane_features[0].data());
+	Lanes::store(floor_holes, lane_features[1].data());
+	Lanes::store(holes, lane_features[2].data());
+	Lanes::store(mono_cells, lane_features[3].data());
+	Lanes::store(row_transitions, lane_features[4].data());
+	Lanes::store(well_depth, lane_features[5].data());
+
+	for (std::size_t a = 0; a < lane_count; a++)
+	{
+		i_features[i_first + a] = {static_cast<float>(aggregate_heights[a]), static_cast<float>(bumpiness[a]), static_cast<float>(lane_features[0][a]), static_cast<float>(lane_features[1][a]), static_cast<float>(lane_features[2][a]), static_cast<float>(i_line_points[i_first + a]), static_cast<float>(lane_features[3][a]), static_cast<float>(lane_features[4][a]), static_cast<float>(lane_features[5][a])};
+	}
+}
+
+void get_batch_features(const std::vector<Board>& i_matrices, const std::vector<unsigned>& i_line_points, unsigned i_locked_rows, std::vector<BotFeatures>& i_features)
+{
+	i_features.resize(i_matrices.size());
+
+	for (std::size_t a = 0; a < i_matrices.size(); a += FeatureLanes::COUNT)
+	{
+		get_lane_features<FeatureLanes>(i_matrices, i_line_points, a, i_locked_rows, i_features);
+	}
+}
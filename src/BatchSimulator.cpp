@@ -0,0 +1,228 @@
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Global.hpp"
+#include "Board.hpp"
+#include "Tetromino.hpp"
+#include "Randomizer.hpp"
+#include "PieceQueue.hpp"
+#include "GameState.hpp"
+#include "ThreadPool.hpp"
+#include "MoveGenerator.hpp"
+#include "TranspositionTable.hpp"
+#include "Bot.hpp"
+#include "Policy.hpp"
+#include "Simulation.hpp"
+#include "Optimizer.hpp"
+
+//About how many frames the autoplay bot takes per tetromino, counting the line clear effect.
+constexpr unsigned DEFAULT_PIECE_FRAMES = 12;
+
+static void print_usage(const char* i_program)
+{
+	std::cerr << "Usage: " << i_program << " [--games N] [--seed N] [--threads N] [--policy greedy|lookahead|random] [--weights w1,...,w9] [--mode beginner|advanced] [--randomizer uniform|bag|bag14|history] [--board WxH] [--max-pieces N] [--piece-frames N] [--optimize GENERATIONS] [--population N] [--checkpoint FILE]" << std::endl;
+}
+
+//Plays many seeded games on every core without a window and prints the totals, for tuning the bot.
+//With "--optimize <generations>" it searches for better weights instead, playing every candidate on the same games.
+int main(int i_argument_count, char** i_arguments)
+{
+	unsigned first_seed = 1;
+	unsigned game_count = 100;
+	unsigned generations = 0;
+	unsigned population_size = 50;
+	unsigned thread_count = std::thread::hardware_concurrency();
+
+	std::string checkpoint_path = "optimizer_checkpoint.txt";
+
+	SimulationSettings settings = {0, ROWS, COLUMNS, 10000, DEFAULT_PIECE_FRAMES, DEFAULT_BOT_WEIGHTS, PolicyType::Greedy, RandomizerType::Uniform};
+
+	for (int a = 1; a < i_argument_count; a += 2)
+	{
+		std::string argument = i_arguments[a];
+
+		//Every flag takes a value, so one at the end is missing it.
+		if (1 + a == i_argument_count)
+		{
+			print_usage(i_arguments[0]);
+
+			return 2;
+		}
+
+		std::string value = i_arguments[1 + a];
+
+		if (argument == "--games")
+		{
+			game_count = static_cast<unsigned>(std::strtoul(value.c_str(), nullptr, 10));
+		}
+		else if (argument == "--seed")
+		{
+			first_seed = static_cast<unsigned>(std::strtoul(value.c_str(), nullptr, 10));
+		}
+		else if (argument == "--threads")
+		{
+			thread_count = static_cast<unsigned>(std::strtoul(value.c_str(), nullptr, 10));
+		}
+		else if (argument == "--optimize")
+		{
+			generations = static_cast<unsigned>(std::strtoul(value.c_str(), nullptr, 10));
+		}
+		else if (argument == "--population")
+		{
+			population_size = static_cast<unsigned>(std::strtoul(value.c_str(), nullptr, 10));
+		}
+		else if (argument == "--checkpoint")
+		{
+			checkpoint_path = value;
+		}
+		else if (argument == "--max-pieces")
+		{
+			settings.max_pieces = static_cast<unsigned>(std::strtoul(value.c_str(), nullptr, 10));
+		}
+		else if (argument == "--piece-frames")
+		{
+			settings.piece_frames = static_cast<unsigned>(std::strtoul(value.c_str(), nullptr, 10));
+		}
+		else if (argument == "--mode")
+		{
+			settings.advanced_mode = value == "advanced";
+		}
+		else if (argument == "--policy")
+		{
+			if (value == "greedy") settings.policy_type = PolicyType::Greedy;
+			else if (value == "lookahead") settings.policy_type = PolicyType::Lookahead;
+			else if (value == "random") settings.policy_type = PolicyType::Random;
+			else
+			{
+				std::cerr << "The policy should be greedy, lookahead or random" << std::endl;
+
+				return 2;
+			}
+		}
+		else if (argument == "--randomizer")
+		{
+			if (value == "uniform") settings.randomizer_type = RandomizerType::Uniform;
+			else if (value == "bag") settings.randomizer_type = RandomizerType::Bag;
+			else if (value == "bag14") settings.randomizer_type = RandomizerType::DoubleBag;
+			else if (value == "history") settings.randomizer_type = RandomizerType::History;
+			else
+			{
+				std::cerr << "The randomizer should be uniform, bag, bag14 or history" << std::endl;
+
+				return 2;
+			}
+		}
+		else if (argument == "--board")
+		{
+			unsigned width = COLUMNS;
+			unsigned height = ROWS;
+			if (2 != std::sscanf(value.c_str(), "%ux%u", &width, &height))
+			{
+				std::cerr << "The board size should look like 10x20" << std::endl;
+
+				return 2;
+			}
+
+			settings.board_height = static_cast<unsigned char>(std::min<unsigned>(height, MAX_ROWS));
+			settings.board_width = static_cast<unsigned char>(std::min<unsigned>(width, MAX_COLUMNS));
+		}
+		else if (argument == "--weights")
+		{
+			if (0 == parse_weights(value, settings.weights))
+			{
+				std::cerr << "The weights should be " << static_cast<unsigned>(BOT_FEATURE_COUNT) << " numbers separated by commas" << std::endl;
+
+				return 2;
+			}
+		}
+		else
+		{
+			print_usage(i_arguments[0]);
+
+			return 2;
+		}
+	}
+
+	ThreadPool thread_pool(thread_count);
+
+	if (0 < generations)
+	{
+		Optimizer optimizer({game_count, population_size, first_seed, 0.05f, 0.2f, checkpoint_path, settings}, thread_pool);
+
+		if (optimizer.load_checkpoint())
+		{
+			std::cout << "Resuming from generation " << optimizer.get_generation() << " of " << checkpoint_path << std::endl;
+		}
+
+		while (optimizer.get_generation() < generations)
+		{
+			std::chrono::time_point<std::chrono::steady_clock> start_time = std::chrono::steady_clock::now();
+
+			optimizer.run_generation();
+
+			const Candidate& best = optimizer.get_population().front();
+
+			std::cout << "Generation " << optimizer.get_generation() << ": best mean score " << best.fitness << " in " << std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count() << " s, --weights " << format_weights(best.weights) << std::endl;
+		}
+
+		return 0;
+	}
+
+	std::chrono::time_point<std::chrono::steady_clock> start_time = std::chrono::steady_clock::now();
+
+	std::vector<GameResult> results = simulate_games(settings, first_seed, game_count, thread_pool);
+
+	double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count();
+
+	unsigned long long table_hits = 0;
+	unsigned long long table_misses = 0;
+	unsigned long long total_lines = 0;
+	unsigned long long total_pieces = 0;
+	unsigned long long total_score = 0;
+
+	unsigned max_lines = 0;
+	unsigned max_pieces = 0;
+	unsigned max_score = 0;
+	unsigned min_lines = results.empty() ? 0 : results[0].lines;
+	unsigned min_pieces = results.empty() ? 0 : results[0].pieces;
+	unsigned min_score = results.empty() ? 0 : results[0].score;
+
+	for (const GameResult& result : results)
+	{
+		total_lines += result.lines;
+		total_pieces += result.pieces;
+		total_score += result.score;
+
+		table_hits += result.table_hits;
+		table_misses += result.table_misses;
+
+		max_lines = std::max(max_lines, result.lines);
+		max_pieces = std::max(max_pieces, result.pieces);
+		max_score = std::max(max_score, result.score);
+		min_lines = std::min(min_lines, result.lines);
+		min_pieces = std::min(min_pieces, result.pieces);
+		min_score = std::min(min_score, result.score);
+	}
+
+	double games = std::max(1u, game_count);
+
+	std::cout << game_count << " games on " << thread_pool.get_thread_count() << " threads in " << seconds << " s, " << game_count / seconds << " games/s, " << total_pieces / seconds << " pieces/s" << std::endl;
+	std::cout << "Score: " << total_score / games << " mean, " << min_score << " min, " << max_score << " max, " << total_score << " total" << std::endl;
+	std::cout << "Lines: " << total_lines / games << " mean, " << min_lines << " min, " << max_lines << " max, " << total_lines << " total" << std::endl;
+	std::cout << "Pieces: " << total_pieces / games << " mean, " << min_pieces << " min, " << max_pieces << " max, " << total_pieces << " total" << std::endl;
+
+	if (0 < table_hits + table_misses)
+	{
+		std::cout << "Transposition table: " << table_hits << " hits, " << table_misses << " misses, " << 100.0 * table_hits / (table_hits + table_misses) << "% hit rate" << std::endl;
+	}
+
+	return 0;
+}
@@ -0,0 +1,386 @@
+#include <algorithm>
+#include <array>
+
+#include "Global.hpp"
+#include "Board.hpp"
+
+using ZobristKeys = std::array<unsigned long long, MAX_ROWS * MAX_COLUMNS * CELL_COLORS>;
+
+//SplitMix64 from a fixed seed, so that hashes are the same in every run.
+static constexpr ZobristKeys make_zobrist_keys()
+{
+	unsigned long long state = 0x5441424c45ull;
+
+	ZobristKeys keys = {};
+
+	for (unsigned long long& key : keys)
+	{
+		state += 0x9e3779b97f4a7c15ull;
+
+		key = state;
+		key = (key ^ (key >> 30)) * 0xbf58476d1ce4e5b9ull;
+		key = (key ^ (key >> 27)) * 0x94d049bb133111ebull;
+		key ^= key >> 31;
+	}
+
+	return keys;
+}
+
+//A key for every cell in every color, made when compiling.
+static constexpr ZobristKeys ZOBRIST_KEYS = make_zobrist_keys();
+
+//The keys of the occupied cells in i_row if it were row i_y, with the colors in i_colors.
+static unsigned long long get_row_hash(unsigned char i_y, unsigned i_row, const std::array<unsigned char, MAX_COLUMNS>& i_colors)
+{
+	unsigned long long hash = 0;
+
+	for (unsigned char a = 0; a < MAX_COLUMNS && 0 != i_row >> a; a++)
+	{
+		if (0 != (i_row & (1u << a)))
+		{
+			hash ^= Board::get_cell_key(a, i_y, i_colors[a]);
+		}
+	}
+
+	return hash;
+}
+
+Board::Board() :
+	Board(COLUMNS, ROWS)
+{
+}
+
+Board::Board(unsigned char i_width, unsigned char i_height) :
+	revision(0),
+	hash(0)
+{
+	resize(i_width, i_height);
+}
+
+bool Board::collides(const std::array<Position, 4>& i_minos, signed char i_offset_x, signed char i_offset_y) const
+{
+	for (const Position& mino : i_minos)
+	{
+		signed char x = mino.x + i_offset_x;
+		signed char y = mino.y + i_offset_y;
+
+		if (0 > x || width <= x || height <= y)
+		{
+			return 1;
+		}
+
+		//Cells above the playfield are always free.
+		if (0 > y)
+		{
+			continue;
+		}
+		else if (0 != (rows[y] & (1u << x)))
+		{
+			return 1;
+		}
+	}
+
+	return 0;
+}
+
+bool Board::is_row_full(unsigned char i_y) const
+{
+	return full_row == rows[i_y];
+}
+
+bool Board::is_row_mono(unsigned char i_y) const
+{
+	for (unsigned char a = 1; a < width; a++)
+	{
+		if (colors[i_y][a] != colors[i_y][0])
+		{
+			return 0;
+		}
+	}
+
+	return 1;
+}
+
+unsigned char Board::get_drop_distance(const std::array<Position, 4>& i_minos) const
+{
+	unsigned char drop_distance = height;
+
+	for (const Position& mino : i_minos)
+	{
+		signed char surface = height - column_heights[mino.x];
+
+		unsigned char mino_distance = 0;
+
+		if (surface > mino.y)
+		{
+			//Everything above the surface is empty, so the mino falls right onto it.
+			mino_distance = surface - mino.y - 1;
+		}
+		else
+		{
+			//The mino is tucked under an overhang, so we have to look for the first occupied cell below it.
+			while (height > 1 + mino.y + mino_distance && 0 == (rows[1 + mino.y + mino_distance] & (1u << mino.x)))
+			{
+				mino_distance++;
+			}
+		}
+
+		drop_distance = std::min(drop_distance, mino_distance);
+	}
+
+	return drop_distance;
+}
+
+unsigned char Board::get_cell(unsigned char i_x, unsigned char i_y) const
+{
+	return colors[i_y][i_x];
+}
+
+unsigned char Board::get_column_height(unsigned char i_x) const
+{
+	return column_heights[i_x];
+}
+
+unsigned char Board::get_height() const
+{
+	return height;
+}
+
+unsigned char Board::get_row_color(unsigned char i_y) const
+{
+	return row_colors[i_y];
+}
+
+unsigned char Board::get_width() const
+{
+	return width;
+}
+
+unsigned long long Board::get_cell_key(unsigned char i_x, unsigned char i_y, unsigned char i_color)
+{
+	return ZOBRIST_KEYS[(i_y * MAX_COLUMNS + i_x) * CELL_COLORS + i_color];
+}
+
+unsigned long long Board::get_hash() const
+{
+	return hash;
+}
+
+unsigned Board::get_full_row() const
+{
+	return full_row;
+}
+
+unsigned Board::get_revision() const
+{
+	return revision;
+}
+
+unsigned Board::get_row(unsigned char i_y) const
+{
+	return rows[i_y];
+}
+
+const std::array<unsigned char, MAX_COLUMNS>& Board::get_column_heights() const
+{
+	return column_heights;
+}
+
+const std::array<unsigned char, MAX_ROWS>& Board::get_row_colors() const
+{
+	return row_colors;
+}
+
+const std::array<unsigned, MAX_ROWS>& Board::get_rows() const
+{
+	return rows;
+}
+
+unsigned char Board::clear_full_rows(unsigned char i_locked_rows)
+{
+	unsigned char cleared_rows = 0;
+
+	//Everything above the highest occupied cell is already empty, so there's no need to move it.
+	signed char top_row = height - *std::max_element(column_heights.begin(), column_heights.begin() + width);
+
+	//Going from the bottom up, every row that stays is copied straight to where it ends up.
+	for (signed char a = height - 1 - i_locked_rows; a >= top_row; a--)
+	{
+		if (full_row == rows[a])
+		{
+			hash ^= get_row_hash(a, rows[a], colors[a]);
+
+			cleared_rows++;
+		}
+		else if (0 < cleared_rows)
+		{
+			//The cells keep their colors but not their keys, since those depend on the row.
+			hash ^= get_row_hash(a, rows[a], colors[a]) ^ get_row_hash(a + cleared_rows, rows[a], colors[a]);
+
+			rows[a + cleared_rows] = rows[a];
+			row_colors[a + cleared_rows] = row_colors[a];
+			colors[a + cleared_rows] = colors[a];
+		}
+	}
+
+	if (0 == cleared_rows)
+	{
+		return 0;
+	}
+
+	revision++;
+
+	for (signed char a = top_row; a < top_row + cleared_rows; a++)
+	{
+		rows[a] = 0;
+		row_colors[a] = 0;
+		colors[a].fill(0);
+	}
+
+	update_column_heights();
+
+	return cleared_rows;
+}
+
+void Board::clear()
+{
+	revision++;
+
+	hash = 0;
+
+	column_heights.fill(0);
+
+	rows.fill(0);
+
+	row_colors.fill(0);
+
+	for (std::array<unsigned char, MAX_COLUMNS>& row : colors)
+	{
+		row.fill(0);
+	}
+}
+
+void Board::fill_row(unsigned char i_y, unsigned char i_color)
+{
+	revision++;
+
+	hash ^= get_row_hash(i_y, rows[i_y], colors[i_y]);
+
+	rows[i_y] = full_row;
+	row_colors[i_y] = i_color;
+
+	std::fill_n(colors[i_y].begin(), width, i_color);
+
+	hash ^= get_row_hash(i_y, rows[i_y], colors[i_y]);
+
+	for (unsigned char a = 0; a < width; a++)
+	{
+		column_heights[a] = std::max<unsigned char>(column_heights[a], height - i_y);
+	}
+}
+
+void Board::resize(unsigned char i_width, unsigned char i_height)
+{
+	height = std::clamp(i_height, MIN_ROWS, MAX_ROWS);
+	width = std::clamp(i_width, MIN_COLUMNS, MAX_COLUMNS);
+
+	//Shifting by 32 would be undefined, so the mask is made in 64 bits.
+	full_row = static_cast<unsigned>((1ull << width) - 1);
+
+	clear();
+}
+
+void Board::set_cell(unsigned char i_x, unsigned char i_y, unsigned char i_color)
+{
+	bool was_occupied = 0 != (rows[i_y] & (1u << i_x));
+
+	revision++;
+
+	if (1 == was_occupied)
+	{
+		hash ^= get_cell_key(i_x, i_y, colors[i_y][i_x]);
+	}
+
+	if (0 != i_color)
+	{
+		hash ^= get_cell_key(i_x, i_y, i_color);
+	}
+
+	if (0 == i_color)
+	{
+		rows[i_y] &= ~(1u << i_x);
+
+		if (height - i_y == column_heights[i_x])
+		{
+			update_column_heights();
+		}
+	}
+	else
+	{
+		rows[i_y] |= 1u << i_x;
+
+		column_heights[i_x] = std::max<unsigned char>(column_heights[i_x], height - i_y);
+	}
+
+	colors[i_y][i_x] = i_color;
+
+	//Removing or repainting a cell can make the rest of the row one color again.
+	if (0 == i_color || 1 == was_occupied)
+	{
+		update_row_color(i_y);
+	}
+	else if (0 == row_colors[i_y])
+	{
+		row_colors[i_y] = i_color;
+	}
+	else if (i_color != row_colors[i_y])
+	{
+		row_colors[i_y] = MIXED_ROW_COLOR;
+	}
+}
+
+void Board::update_column_heights()
+{
+	unsigned found_columns = 0;
+
+	column_heights.fill(0);
+
+	//Going from the top down, the first row where a column is occupied gives its height.
+	for (unsigned char a = 0; a < height && full_row != found_columns; a++)
+	{
+		unsigned new_columns = rows[a] & ~found_columns;
+
+		found_columns |= new_columns;
+
+		for (unsigned char b = 0; 0 != new_columns; b++, new_columns >>= 1)
+		{
+			if (0 != (new_columns & 1))
+			{
+				column_heights[b] = height - a;
+			}
+		}
+	}
+}
+
+void Board::update_row_color(unsigned char i_y)
+{
+	row_colors[i_y] = 0;
+
+	for (unsigned char a = 0; a < width; a++)
+	{
+		if (0 == (rows[i_y] & (1u << a)))
+		{
+			continue;
+		}
+		else if (0 == row_colors[i_y])
+		{
+			row_colors[i_y] = colors[i_y][a];
+		}
+		else if (colors[i_y][a] != row_colors[i_y])
+		{
+			row_colors[i_y] = MIXED_ROW_COLOR;
+
+			return;
+		}
+	}
+}
@@ -0,0 +1,515 @@
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdlib>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "Global.hpp"
+#include "Board.hpp"
+#include "Tetromino.hpp"
+#include "Randomizer.hpp"
+#include "PieceQueue.hpp"
+#include "GameState.hpp"
+#include "ThreadPool.hpp"
+#include "MoveGenerator.hpp"
+#include "TranspositionTable.hpp"
+#include "Bot.hpp"
+#include "BatchFeatures.hpp"
+
+//If the bot can't reach its placement in this many frames, it just drops the tetromino where it is.
+//Long enough to soft drop to the bottom of the tallest matrix on the way to a placement under an overhang.
+constexpr unsigned short BOT_GIVE_UP_FRAMES = 600;
+
+static unsigned char count_bits(unsigned i_bits)
+{
+	unsigned char count = 0;
+
+	for (; 0 != i_bits; i_bits &= i_bits - 1)
+	{
+		count++;
+	}
+
+	return count;
+}
+
+static signed char get_column(const std::array<Position, 4>& i_minos)
+{
+	signed char column = i_minos[0].x;
+
+	for (const Position& mino : i_minos)
+	{
+		column = std::min(column, mino.x);
+	}
+
+	return column;
+}
+
+Bot::Bot(const BotWeights& i_weights, ThreadPool& i_thread_pool) :
+	has_plan(0),
+	previous_keys(0),
+	plan_frames(0),
+	planned_piece(0),
+	weights(i_weights),
+	moves(),
+	plan(),
+	table(BOT_TABLE_BITS),
+	thread_pool(i_thread_pool),
+	path(),
+	placements(),
+	workspaces(1 + i_thread_pool.get_thread_count())
+{
+}
+
+InputFrame Bot::get_input(GameState& i_game)
+{
+	InputFrame input = {};
+
+	if (0 < i_game.clear_effect_timer || 1 == i_game.game_over)
+	{
+		previous_keys = 0;
+
+		return input;
+	}
+
+	if (0 == has_plan || planned_piece != i_game.pieces_placed)
+	{
+		has_plan = 1;
+
+		plan_frames = 0;
+		planned_piece = i_game.pieces_placed;
+
+		plan = find_placement(i_game);
+	}
+
+	plan_frames++;
+
+	//Single shifts are taps, the other keys are either held until they're done or only act when they go down.
+	unsigned char tapped_keys = INPUT_ROTATE_CCW | INPUT_ROTATE_CW | INPUT_HARD_DROP;
+
+	moves.search(i_game.tetromino, i_game.matrix);
+
+	//If gravity took the placement out of reach, the best we can do is drop the tetromino where it is.
+	if (BOT_GIVE_UP_FRAMES < plan_frames || 0 == moves.get_path(plan.minos, path))
+	{
+		input.keys = INPUT_HARD_DROP;
+	}
+	//A hard drop lands where the last soft drop would, just right away.
+	else if (1 == path.empty() || (1 == path.size() && Move::SoftDrop == path[0]))
+	{
+		input.keys = INPUT_HARD_DROP;
+	}
+	else
+	{
+		switch (path[0])
+		{
+			case Move::Left:
+			{
+				input.keys = INPUT_LEFT;
+				tapped_keys |= INPUT_LEFT;
+
+				break;
+			}
+			case Move::Right:
+			{
+				input.keys = INPUT_RIGHT;
+				tapped_keys |= INPUT_RIGHT;
+
+				break;
+			}
+			case Move::DasLeft:
+			{
+				input.keys = INPUT_LEFT;
+
+				break;
+			}
+			case Move::DasRight:
+			{
+				input.keys = INPUT_RIGHT;
+
+				break;
+			}
+			case Move::RotateCw:
+			{
+				input.keys = INPUT_ROTATE_CW;
+
+				break;
+			}
+			case Move::RotateCcw:
+			{
+				input.keys = INPUT_ROTATE_CCW;
+
+				break;
+			}
+			default:
+			{
+				input.keys = INPUT_SOFT_DROP;
+			}
+		}
+	}
+
+	//A tapped key only acts when it goes down, so we have to let go of it every other frame.
+	input.keys &= ~(previous_keys & tapped_keys);
+
+	previous_keys = input.keys;
+
+	return input;
+}
+
+Placement Bot::find_placement(GameState& i_game)
+{
+	get_placements(i_game.tetromino, i_game.matrix, moves, placements);
+
+	if (1 == placements.empty())
+	{
+		Placement placement = {get_column(i_game.tetromino.get_minos()), i_game.tetromino.get_rotation(), TOP_OUT_SCORE, i_game.tetromino.get_minos()};
+
+		return placement;
+	}
+
+	table.new_search();
+
+	//Every placement of the current tetromino is one task, which goes through every placement of the next tetromino.
+	for (Placement& placement : placements)
+	{
+		thread_pool.push([this, &i_game, &placement]()
+		{
+			Board matrix = i_game.matrix;
+
+			unsigned line_points = lock_placement(matrix, placement.minos, i_game.tetromino.get_shape(), i_game.locked_rows);
+
+			Tetromino next_tetromino(i_game.piece_queue.get(0), matrix);
+
+			placement.score = TOP_OUT_SCORE;
+
+			if (0 == next_tetromino.reset(i_game.piece_queue.get(0), matrix))
+			{
+				return;
+			}
+
+			Workspace& workspace = workspaces[thread_pool.get_thread_index()];
+
+			get_placements(next_tetromino, matrix, workspace.moves, workspace.placements);
+
+			placement.score = get_best_next_score(matrix, workspace.placements, i_game.piece_queue.get(0), line_points, i_game.locked_rows, weights, table, workspace.buffers);
+		});
+	}
+
+	thread_pool.wait();
+
+	return *std::max_element(placements.begin(), placements.end(), [](const Placement& i_a, const Placement& i_b)
+	{
+		return i_a.score < i_b.score;
+	});
+}
+
+const TranspositionTable& Bot::get_table() const
+{
+	return table;
+}
+
+void Bot::reset()
+{
+	has_plan = 0;
+
+	previous_keys = 0;
+}
+
+float evaluate_features(const BotFeatures& i_features, const BotWeights& i_weights)
+{
+	float score = 0;
+
+	for (unsigned char a = 0; a < BOT_FEATURE_COUNT; a++)
+	{
+		score += i_weights[a] * i_features[a];
+	}
+
+	return score;
+}
+
+float evaluate_matrix(const Board& i_matrix, unsigned i_line_points, unsigned i_locked_rows, const BotWeights& i_weights)
+{
+	return evaluate_features(get_features(i_matrix, i_line_points, i_locked_rows), i_weights);
+}
+
+float get_best_next_score(const Board& i_matrix, const std::vector<Placement>& i_placements, unsigned char i_shape, unsigned i_line_points, unsigned i_locked_rows, const BotWeights& i_weights, TranspositionTable& i_table, PlacementBuffers& i_buffers)
+{
+	float best_score = TOP_OUT_SCORE;
+
+	unsigned long long hits = 0;
+	unsigned long long misses = 0;
+
+	i_buffers.keys.clear();
+	i_buffers.line_points.clear();
+	i_buffers.matrices.clear();
+
+	for (const Placement& placement : i_placements)
+	{
+		float score = 0;
+
+		unsigned long long key = get_placement_key(i_matrix, placement.minos, i_shape, i_line_points, i_locked_rows);
+
+		if (0 != key && 1 == i_table.find(key, score))
+		{
+			best_score = std::max(best_score, score);
+
+			hits++;
+
+			continue;
+		}
+
+		misses += 0 != key;
+
+		i_buffers.keys.push_back(key);
+		i_buffers.matrices.push_back(i_matrix);
+		i_buffers.line_points.push_back(i_line_points + lock_placement(i_buffers.matrices.back(), placement.minos, i_shape, i_locked_rows));
+	}
+
+	//Everything that wasn't in the table is measured at once.
+	get_batch_features(i_buffers.matrices, i_buffers.line_points, i_locked_rows, i_buffers.features);
+
+	for (std::size_t a = 0; a < i_buffers.features.size(); a++)
+	{
+		float score = evaluate_features(i_buffers.features[a], i_weights);
+
+		if (0 != i_buffers.keys[a])
+		{
+			i_table.store(i_buffers.keys[a], score);
+		}
+
+		best_score = std::max(best_score, score);
+	}
+
+	i_table.count_lookups(hits, misses);
+
+	return best_score;
+}
+
+unsigned long long get_placement_key(const Board& i_matrix, const std::array<Position, 4>& i_minos, unsigned char i_shape, unsigned i_line_points, unsigned i_locked_rows)
+{
+	//The points and the locked rows change the score, so they're part of the key. The odd constants spread them over every bit.
+	unsigned long long key = i_matrix.get_hash() ^ (1 + i_line_points) * 0x9e3779b97f4a7c15ull ^ (1 + i_locked_rows) * 0xc2b2ae3d27d4eb4full;
+
+	for (const Position& mino : i_minos)
+	{
+		if (0 > mino.y)
+		{
+			continue;
+		}
+
+		unsigned row = i_matrix.get_row(mino.y);
+
+		for (const Position& other_mino : i_minos)
+		{
+			if (other_mino.y == mino.y)
+			{
+				row |= 1u << other_mino.x;
+			}
+		}
+
+		if (i_matrix.get_full_row() == row)
+		{
+			return 0;
+		}
+
+		key ^= Board::get_cell_key(mino.x, mino.y, 1 + i_shape);
+	}
+
+	//0 is an empty slot in the table.
+	return 0 == key ? 1 : key;
+}
+
+BotFeatures get_features(const Board& i_matrix, unsigned i_line_points, unsigned i_locked_rows)
+{
+	unsigned aggregate_height = 0;
+	unsigned bumpiness = 0;
+	unsigned column_transitions = 0;
+	unsigned covered_columns = 0;
+	unsigned floor_holes = 0;
+	unsigned holes = 0;
+	unsigned mono_cells = 0;
+	unsigned previous_row = 0;
+	unsigned previous_wells = 0;
+	unsigned row_transitions = 0;
+	unsigned well_depth = 0;
+
+	unsigned char stack_height = 0;
+
+	unsigned full_row = i_matrix.get_full_row();
+	//Rows can be 32 columns wide, so the walls can't be bits next to the row.
+	unsigned last_column = 1u << (i_matrix.get_width() - 1);
+
+	std::array<unsigned char, MAX_COLUMNS> well_heights = {};
+
+	for (unsigned char a = 0; a < i_matrix.get_width(); a++)
+	{
+		aggregate_height += i_matrix.get_column_height(a);
+
+		stack_height = std::max(stack_height, i_matrix.get_column_height(a));
+
+		if (0 < a)
+		{
+			bumpiness += std::abs(i_matrix.get_column_height(a) - i_matrix.get_column_height(a - 1));
+		}
+	}
+
+	//The empty rows above the stack add nothing to any feature.
+	for (unsigned char a = i_matrix.get_height() - stack_height; a < i_matrix.get_height(); a++)
+	{
+		unsigned row = i_matrix.get_row(a);
+
+		//A hole is an empty cell with an occupied cell somewhere above it.
+		unsigned row_holes = count_bits(covered_columns & ~row);
+
+		holes += row_holes;
+
+		if (a + 1 + i_locked_rows == i_matrix.get_height())
+		{
+			floor_holes = row_holes;
+		}
+
+		covered_columns |= row;
+
+		column_transitions += count_bits(previous_row ^ row);
+
+		previous_row = row;
+
+		if (0 != row)
+		{
+			row_transitions += count_bits((row ^ row >> 1) & full_row >> 1) + (0 == (row & 1)) + (0 == (row & last_column));
+
+			if (full_row != row)
+			{
+				unsigned char color = 0;
+
+				bool mono = 1;
+
+				for (unsigned char b = 0; 1 == mono && b < i_matrix.get_width(); b++)
+				{
+					if (0 != (row & 1u << b))
+					{
+						mono = 0 == color || color == i_matrix.get_cell(b, a);
+
+						color = i_matrix.get_cell(b, a);
+					}
+				}
+
+				mono_cells += mono * count_bits(row);
+			}
+		}
+
+		unsigned wells = full_row & ~row & (1 | row << 1) & (last_column | row >> 1);
+
+		for (unsigned char b = 0; b < i_matrix.get_width() && 0 != wells >> b; b++)
+		{
+			if (0 != (wells & 1u << b))
+			{
+				well_heights[b] = 0 == (previous_wells & 1u << b) ? 1 : 1 + well_heights[b];
+
+				well_depth += well_heights[b];
+			}
+		}
+
+		previous_wells = wells;
+	}
+
+	column_transitions += count_bits(full_row & ~previous_row);
+
+	return {static_cast<float>(aggregate_height), static_cast<float>(bumpiness), static_cast<float>(column_transitions), static_cast<float>(floor_holes), static_cast<float>(holes), static_cast<float>(i_line_points), static_cast<float>(mono_cells), static_cast<float>(row_transitions), static_cast<float>(well_depth)};
+}
+
+void get_placements(const Tetromino& i_tetromino, const Board& i_matrix, MoveGenerator& i_moves, std::vector<Placement>& i_placements)
+{
+	i_placements.clear();
+
+	i_moves.search(i_tetromino, i_matrix);
+
+	for (unsigned short a = 0; a < i_moves.get_landing_count(); a++)
+	{
+		const std::array<Position, 4>& minos = i_moves.get_landing_minos(a);
+
+		i_placements.push_back({get_column(minos), i_moves.get_landing_rotation(a), 0, minos});
+	}
+}
+
+unsigned lock_placement(Board& i_matrix, const std::array<Position, 4>& i_minos, unsigned char i_shape, unsigned i_locked_rows)
+{
+	unsigned cleared_lines = 0;
+	unsigned mono_lines = 0;
+
+	for (const Position& mino : i_minos)
+	{
+		if (0 <= mino.y)
+		{
+			i_matrix.set_cell(mino.x, mino.y, 1 + i_shape);
+		}
+	}
+
+	for (unsigned char a = 0; a < i_matrix.get_height() - i_locked_rows; a++)
+	{
+		if (1 == i_matrix.is_row_full(a))
+		{
+			cleared_lines++;
+
+			if (1 == i_matrix.is_row_mono(a))
+			{
+				mono_lines++;
+			}
+		}
+	}
+
+	if (0 == cleared_lines)
+	{
+		return 0;
+	}
+
+	i_matrix.clear_full_rows(static_cast<unsigned char>(i_locked_rows));
+
+	return SCORE_TABLE[std::min<unsigned>(cleared_lines, 4) - 1] + MONO_LINE_BONUS * mono_lines;
+}
+
+std::string format_weights(const BotWeights& i_weights)
+{
+	std::ostringstream text;
+
+	text.precision(9);
+
+	for (unsigned char a = 0; a < BOT_FEATURE_COUNT; a++)
+	{
+		text << (0 == a ? "" : ",") << i_weights[a];
+	}
+
+	return text.str();
+}
+
+bool parse_weights(const std::string& i_text, BotWeights& i_weights)
+{
+	std::istringstream text(i_text);
+
+	BotWeights weights = {};
+
+	for (unsigned char a = 0; a < BOT_FEATURE_COUNT; a++)
+	{
+		if (!(text >> weights[a]))
+		{
+			return 0;
+		}
+
+		char separator = 0;
+
+		if (!(text >> separator))
+		{
+			break;
+		}
+		else if (',' != separator || BOT_FEATURE_COUNT == 1 + a)
+		{
+			return 0;
+		}
+	}
+
+	i_weights = weights;
+
+	return 1;
+}
@@ -1,60 +1,29 @@
 #include <SFML/Graphics.hpp>
-#include <array>
-#include <iostream>
+#include <string>
+#include <unordered_map>
 
-#include "Headers/DrawText.hpp"
+#include "DrawText.hpp"
+#include "TextCache.hpp"
 
-void draw_text(unsigned short i_x, unsigned short i_y, const std::string& i_text, sf::RenderWindow& i_window)
+static TextCache text_cache;
+
+void draw_label(unsigned short i_x, unsigned short i_y, const std::string& i_text)
 {
-	static sf::Font font;
-	static bool font_loaded = false;
-	static bool warned = false;
-	if (!font_loaded)
-	{
-		const std::array<std::string, 4> font_paths = {
-			"Resources/Images/Font.ttf",
-			"/mingw64/share/fonts/TTF/DejaVuSans.ttf",
-			"C:/Windows/Fonts/arial.ttf",
-			"C:/Windows/Fonts/segoeui.ttf"
-		};
-		for (const auto& path : font_paths)
-		{
-			if (font.openFromFile(path))
-			{
-				font_loaded = true;
-				break;
-			}
-		}
-		if (!font_loaded && !warned)
-		{
-			std::cerr << "Failed to load any font. Checked: Resources/Images/Font.ttf, DejaVuSans, Arial, Segoe UI." << std::endl;
-			warned = true;
-		}
-	}
+	text_cache.add_label(i_x, i_y, i_text);
+}
 
-	if (!font_loaded) return;
+void draw_labels(sf::RenderWindow& i_window)
+{
+	text_cache.draw_labels(i_window);
+	text_cache.end_frame();
+}
 
-	sf::Text text(font);
-	text.setCharacterSize(10);
-	text.setFillColor(sf::Color::White);
+void draw_text(unsigned short i_x, unsigned short i_y, const std::string& i_text, sf::RenderWindow& i_window)
+{
+	text_cache.draw(i_x, i_y, i_text, i_window);
+}
 
-	float x = static_cast<float>(i_x);
-	float y = static_cast<float>(i_y);
-	std::string line;
-	for (char ch : i_text)
-	{
-		if (ch == '\n')
-		{
-			text.setString(line);
-			text.setPosition(sf::Vector2f(x, y));
-			i_window.draw(text);
-			line.clear();
-			y += text.getCharacterSize();
-			continue;
-		}
-		line.push_back(ch);
-	}
-	text.setString(line);
-	text.setPosition(sf::Vector2f(x, y));
-	i_window.draw(text);
-}
\ No newline at end of file
+void set_text_font(const sf::Font& i_font)
+{
+	text_cache.set_font(i_font);
+}
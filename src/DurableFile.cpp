@@ -0,0 +1,149 @@
+#include <cstdio>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <fcntl.h>
+#include <io.h>
+#include <sys/stat.h>
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "DurableFile.hpp"
+
+#ifdef _WIN32
+int open_for_writing(const std::string& i_path, bool i_append)
+{
+	return _open(i_path.c_str(), _O_WRONLY | _O_CREAT | _O_BINARY | (1 == i_append ? _O_APPEND : _O_TRUNC), _S_IREAD | _S_IWRITE);
+}
+
+long long get_file_size(int i_descriptor)
+{
+	return _lseeki64(i_descriptor, 0, SEEK_END);
+}
+
+bool write_all(int i_descriptor, const std::vector<unsigned char>& i_bytes)
+{
+	return static_cast<int>(i_bytes.size()) == _write(i_descriptor, i_bytes.data(), static_cast<unsigned>(i_bytes.size()));
+}
+
+bool sync_file(int i_descriptor)
+{
+	return 0 == _commit(i_descriptor);
+}
+
+void truncate_file(int i_descriptor, long long i_size)
+{
+	_chsize_s(i_descriptor, i_size);
+}
+
+void close_file(int i_descriptor)
+{
+	_close(i_descriptor);
+}
+
+bool replace_file(const std::string& i_source, const std::string& i_destination)
+{
+	return 0 != MoveFileExA(i_source.c_str(), i_destination.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH);
+}
+#else
+int open_for_writing(const std::string& i_path, bool i_append)
+{
+	return ::open(i_path.c_str(), O_WRONLY | O_CREAT | (1 == i_append ? O_APPEND : O_TRUNC), 0644);
+}
+
+long long get_file_size(int i_descriptor)
+{
+	struct stat file_status;
+
+	return 0 == fstat(i_descriptor, &file_status) ? static_cast<long long>(file_status.st_size) : -1;
+}
+
+bool write_all(int i_descriptor, const std::vector<unsigned char>& i_bytes)
+{
+	std::size_t offset = 0;
+
+	while (offset < i_bytes.size())
+	{
+		ssize_t written = ::write(i_descriptor, offset + i_bytes.data(), i_bytes.size() - offset);
+
+		if (0 >= written)
+		{
+			return 0;
+		}
+
+		offset += static_cast<std::size_t>(written);
+	}
+
+	return 1;
+}
+
+bool sync_file(int i_descriptor)
+{
+	return 0 == fsync(i_descriptor);
+}
+
+void truncate_file(int i_descriptor, long long i_size)
+{
+	(void)ftruncate(i_descriptor, static_cast<off_t>(i_size));
+}
+
+void close_file(int i_descriptor)
+{
+	::close(i_descriptor);
+}
+
+bool replace_file(const std::string& i_source, const std::string& i_destination)
+{
+	if (0 != std::rename(i_source.c_str(), i_destination.c_str()))
+	{
+		return 0;
+	}
+
+	//The rename itself is only durable once the directory is synced.
+	std::string directory = std::filesystem::path(i_destination).parent_path().string();
+
+	int descriptor = ::open(directory.empty() ? "." : directory.c_str(), O_RDONLY);
+
+	if (0 <= descriptor)
+	{
+		fsync(descriptor);
+
+		::close(descriptor);
+	}
+
+	return 1;
+}
+#endif
+
+bool replace_file_contents(const std::string& i_path, const std::vector<unsigned char>& i_bytes)
+{
+	std::string temporary_path = i_path + ".tmp";
+
+	int descriptor = open_for_writing(temporary_path, 0);
+
+	if (0 > descriptor)
+	{
+		return 0;
+	}
+
+	bool written = write_all(descriptor, i_bytes) && sync_file(descriptor);
+
+	close_file(descriptor);
+
+	if (1 == written && 1 == replace_file(temporary_path, i_path))
+	{
+		return 1;
+	}
+
+	std::remove(temporary_path.c_str());
+
+	return 0;
+}
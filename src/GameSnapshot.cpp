@@ -0,0 +1,58 @@
+#include <array>
+#include <chrono>
+#include <memory>
+#include <vector>
+
+#include "Global.hpp"
+#include "Board.hpp"
+#include "Tetromino.hpp"
+#include "Randomizer.hpp"
+#include "PieceQueue.hpp"
+#include "GameState.hpp"
+#include "GameSnapshot.hpp"
+
+GameSnapshot::GameSnapshot() :
+	advanced_mode(0),
+	game_over(0),
+	clear_effect_timer(0),
+	current_fall_speed(START_FALL_SPEED),
+	preview_count(1),
+	level(1),
+	lines_cleared(0),
+	locked_rows(0),
+	score(0),
+	accumulated_play_time(0),
+	next_shapes(),
+	clear_lines(ROWS, 0),
+	tetromino(0, matrix)
+{
+}
+
+void take_snapshot(const GameState& i_game, GameSnapshot& i_snapshot)
+{
+	i_snapshot.advanced_mode = i_game.advanced_mode;
+	i_snapshot.game_over = i_game.game_over;
+
+	i_snapshot.clear_effect_timer = i_game.clear_effect_timer;
+	i_snapshot.current_fall_speed = i_game.current_fall_speed;
+	i_snapshot.preview_count = i_game.piece_queue.get_count();
+
+	i_snapshot.level = i_game.level;
+	i_snapshot.lines_cleared = i_game.lines_cleared;
+	i_snapshot.locked_rows = i_game.locked_rows;
+	i_snapshot.score = i_game.score;
+
+	i_snapshot.accumulated_play_time = i_game.accumulated_play_time;
+
+	for (unsigned char a = 0; a < i_snapshot.preview_count; a++)
+	{
+		i_snapshot.next_shapes[a] = i_game.piece_queue.get(a);
+	}
+
+	i_snapshot.clear_lines = i_game.clear_lines;
+
+	i_snapshot.matrix = i_game.matrix;
+
+	//The copy still points at the ghost of the live matrix, so its ghost gets recalculated against the snapshot's matrix.
+	i_snapshot.tetromino = i_game.tetromino;
+}
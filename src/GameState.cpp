@@ -0,0 +1,516 @@
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <climits>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "Global.hpp"
+#include "Board.hpp"
+#include "Tetromino.hpp"
+#include "Randomizer.hpp"
+#include "PieceQueue.hpp"
+#include "GameState.hpp"
+
+//Every time this much play time passes, one more garbage row gets locked at the bottom.
+constexpr std::chrono::microseconds DIFFICULTY_INTERVAL(5 * 60 * 1000000ll);
+
+GameState::GameState(unsigned i_seed) :
+	advanced_mode(0),
+	game_over(0),
+	hard_drop_pressed(0),
+	rotate_pressed(0),
+	shift_charged(0),
+	clear_effect_timer(0),
+	current_fall_speed(START_FALL_SPEED),
+	fall_timer(0),
+	preview_count(1),
+	previous_keys(0),
+	soft_drop_factor(DEFAULT_SOFT_DROP_FACTOR),
+	arr(DEFAULT_ARR),
+	das(DEFAULT_DAS),
+	level(1),
+	lines_cleared(0),
+	locked_rows(0),
+	pieces_placed(0),
+	score(0),
+	shift_timer(0),
+	soft_drop_timer(0),
+	accumulated_play_time(0),
+	clear_lines(ROWS, 0),
+	randomizer_type(RandomizerType::Uniform),
+	tetromino(0, matrix)
+{
+	reset(0, i_seed);
+}
+
+bool GameState::act(bool& i_hard_dropped)
+{
+	bool changed = 0;
+
+	if (0 == rotate_pressed)
+	{
+		if (0 != (previous_keys & INPUT_ROTATE_CCW))
+		{
+			rotate_pressed = 1;
+
+			changed |= tetromino.rotate(0, matrix);
+		}
+		else if (0 != (previous_keys & INPUT_ROTATE_CW))
+		{
+			rotate_pressed = 1;
+
+			changed |= tetromino.rotate(1, matrix);
+		}
+	}
+
+	if (0 == shift_timer && 0 != (previous_keys & (INPUT_LEFT | INPUT_RIGHT)))
+	{
+		changed |= shift();
+	}
+
+	if (0 == hard_drop_pressed && 0 != (previous_keys & INPUT_HARD_DROP))
+	{
+		changed = 1;
+		hard_drop_pressed = 1;
+		i_hard_dropped = 1;
+
+		fall_timer = current_fall_speed;
+
+		tetromino.hard_drop(matrix);
+
+		return changed;
+	}
+
+	if (0 == soft_drop_timer && 0 != (previous_keys & INPUT_SOFT_DROP))
+	{
+		changed |= soft_drop();
+	}
+
+	return changed;
+}
+
+bool GameState::advance(unsigned i_time, bool i_hard_dropped)
+{
+	bool changed = 0;
+
+	unsigned time = i_time;
+
+	//Most updates have nothing running.
+	if (0 == shift_timer && 0 == soft_drop_timer)
+	{
+		return 0;
+	}
+
+	while (1)
+	{
+		//How long until the next shift and the next soft drop, if they're running.
+		unsigned shift_due = 0 != (previous_keys & (INPUT_LEFT | INPUT_RIGHT)) && 0 < shift_timer ? shift_timer : UINT_MAX;
+		unsigned soft_drop_due = 0 != (previous_keys & INPUT_SOFT_DROP) && 0 < soft_drop_timer ? soft_drop_timer : UINT_MAX;
+
+		unsigned due = std::min(shift_due, soft_drop_due);
+
+		//A timer that runs out exactly at the end is left at 0, so it fires at the start of the next update like it always did.
+		if (time <= due)
+		{
+			break;
+		}
+
+		time -= due;
+
+		shift_timer -= std::min(due, shift_timer);
+		soft_drop_timer -= std::min(due, soft_drop_timer);
+
+		if (shift_due == due)
+		{
+			shift_charged = 1;
+
+			if (0 == i_hard_dropped)
+			{
+				changed |= shift();
+			}
+		}
+
+		if (soft_drop_due == due && 0 == i_hard_dropped)
+		{
+			changed |= soft_drop();
+		}
+	}
+
+	if (0 < shift_timer)
+	{
+		shift_timer -= std::min(time, shift_timer);
+
+		shift_charged |= 0 == shift_timer;
+	}
+
+	soft_drop_timer -= std::min(time, soft_drop_timer);
+
+	return changed;
+}
+
+void GameState::add_cleared_lines(unsigned i_lines, unsigned i_mono_lines)
+{
+	if (0 == i_lines)
+	{
+		return;
+	}
+
+	lines_cleared += i_lines;
+
+	//Clearing a line made of a single color is worth a bonus.
+	score += (SCORE_TABLE[std::min<unsigned>(i_lines, 4) - 1] + MONO_LINE_BONUS * i_mono_lines) * level;
+
+	update_level_speed();
+}
+
+void GameState::apply_event(const InputEvent& i_event)
+{
+	if (1 == i_event.pressed)
+	{
+		previous_keys |= i_event.key;
+
+		return;
+	}
+
+	previous_keys &= ~i_event.key;
+
+	if (0 != (i_event.key & (INPUT_ROTATE_CCW | INPUT_ROTATE_CW)))
+	{
+		rotate_pressed = 0;
+	}
+
+	if (0 != (i_event.key & INPUT_SOFT_DROP))
+	{
+		soft_drop_timer = 0;
+	}
+
+	if (0 != (i_event.key & (INPUT_LEFT | INPUT_RIGHT)))
+	{
+		shift_charged = 0;
+		shift_timer = 0;
+	}
+
+	if (0 != (i_event.key & INPUT_HARD_DROP))
+	{
+		hard_drop_pressed = 0;
+	}
+}
+
+void GameState::fill_locked_rows()
+{
+	for (unsigned char a = 0; a < locked_rows; a++)
+	{
+		matrix.fill_row(static_cast<unsigned char>(matrix.get_height() - 1 - a), 8);
+	}
+}
+
+void GameState::place(const std::array<Position, 4>& i_minos, unsigned i_frames)
+{
+	unsigned cleared_now = 0;
+	unsigned mono_cleared = 0;
+
+	pieces_placed++;
+
+	for (const Position& mino : i_minos)
+	{
+		if (0 <= mino.y)
+		{
+			matrix.set_cell(mino.x, mino.y, 1 + tetromino.get_shape());
+		}
+	}
+
+	for (unsigned char a = 0; a < matrix.get_height() - locked_rows; a++)
+	{
+		if (1 == matrix.is_row_full(a))
+		{
+			cleared_now++;
+
+			if (1 == matrix.is_row_mono(a))
+			{
+				mono_cleared++;
+			}
+		}
+	}
+
+	add_cleared_lines(cleared_now, mono_cleared);
+
+	if (0 < cleared_now)
+	{
+		matrix.clear_full_rows(static_cast<unsigned char>(locked_rows));
+	}
+
+	accumulated_play_time += std::chrono::microseconds(FRAME_DURATION) * i_frames;
+
+	//The floor rises while the tetromino is on its way, but only shows up once it has landed.
+	while (accumulated_play_time >= DIFFICULTY_INTERVAL * (locked_rows + 1) && locked_rows + 1 < matrix.get_height())
+	{
+		locked_rows++;
+
+		fill_locked_rows();
+	}
+
+	game_over = 0 == tetromino.reset(piece_queue.pop(*randomizer), matrix);
+}
+
+void GameState::reset(bool i_advanced_mode, unsigned i_seed)
+{
+	advanced_mode = i_advanced_mode;
+	game_over = 0;
+	hard_drop_pressed = 0;
+	rotate_pressed = 0;
+	shift_charged = 0;
+
+	clear_effect_timer = 0;
+	fall_timer = 0;
+	previous_keys = 0;
+
+	level = 1 == advanced_mode ? 2 : 1;
+	lines_cleared = 0;
+	locked_rows = 0;
+	pieces_placed = 0;
+	score = 0;
+	shift_timer = 0;
+	soft_drop_timer = 0;
+
+	current_fall_speed = static_cast<unsigned char>(std::max<int>(SOFT_DROP_SPEED, START_FALL_SPEED - static_cast<int>(level - 1)));
+
+	accumulated_play_time = std::chrono::microseconds(0);
+
+	matrix.clear();
+
+	std::fill(clear_lines.begin(), clear_lines.end(), 0);
+
+	fill_locked_rows();
+
+	//Beginner mode only uses the first 4 shapes.
+	randomizer = make_randomizer(randomizer_type, 1 == advanced_mode ? 7 : 4, i_seed);
+
+	piece_queue.reset(preview_count, *randomizer);
+
+	tetromino = Tetromino(piece_queue.pop(*randomizer), matrix);
+}
+
+bool GameState::shift()
+{
+	bool left = 0 != (previous_keys & INPUT_LEFT);
+	bool changed = left ? tetromino.move_left(matrix) : tetromino.move_right(matrix);
+
+	if (0 == das)
+	{
+		shift_charged = 1;
+	}
+
+	if (0 == shift_charged)
+	{
+		shift_timer = das;
+	}
+	else if (0 < arr)
+	{
+		shift_timer = arr;
+	}
+	else
+	{
+		//The timer stays at 0, so the tetromino keeps being pushed against the wall for as long as the key is held.
+		while (1 == (left ? tetromino.move_left(matrix) : tetromino.move_right(matrix)))
+		{
+			changed = 1;
+		}
+	}
+
+	return changed;
+}
+
+bool GameState::soft_drop()
+{
+	if (0 == tetromino.move_down(matrix))
+	{
+		return 0;
+	}
+
+	fall_timer = 0;
+
+	//Soft drop is never slower than gravity.
+	soft_drop_timer = std::max(1u, std::min<unsigned>(FRAME_DURATION * current_fall_speed, FRAME_DURATION * START_FALL_SPEED / std::max<unsigned char>(1, soft_drop_factor)));
+
+	return 1;
+}
+
+bool GameState::step(const InputFrame& i_input)
+{
+	bool changed = 0;
+	bool hard_dropped = 0;
+
+	unsigned char event_count = 0;
+	unsigned char next_event = 0;
+
+	unsigned short time = 0;
+
+	std::array<InputEvent, MAX_INPUT_EVENTS> events;
+
+	if (0 == i_input.event_count)
+	{
+		unsigned char pressed_keys = i_input.keys & ~previous_keys;
+		unsigned char released_keys = previous_keys & ~i_input.keys;
+
+		//Everything that was released goes first.
+		for (unsigned char a = 0; 0 != (pressed_keys | released_keys) && a < 2 * CHAR_BIT; a++)
+		{
+			unsigned char key = static_cast<unsigned char>(1 << a % CHAR_BIT);
+
+			if (0 != (key & (a < CHAR_BIT ? released_keys : pressed_keys)))
+			{
+				events[event_count++] = {CHAR_BIT <= a, key, 0};
+			}
+		}
+	}
+	else
+	{
+		event_count = std::min(i_input.event_count, MAX_INPUT_EVENTS);
+
+		for (unsigned char a = 0; a < event_count; a++)
+		{
+			events[a] = i_input.events[a];
+			events[a].time = std::min<unsigned short>(events[a].time, FRAME_DURATION - 1);
+		}
+
+		std::stable_sort(events.begin(), events.begin() + event_count, [](const InputEvent& i_a, const InputEvent& i_b)
+		{
+			return i_a.time < i_b.time;
+		});
+	}
+
+	//The play time is shown in seconds.
+	changed = std::chrono::duration_cast<std::chrono::seconds>(accumulated_play_time) != std::chrono::duration_cast<std::chrono::seconds>(accumulated_play_time + std::chrono::microseconds(FRAME_DURATION));
+
+	accumulated_play_time += std::chrono::microseconds(FRAME_DURATION);
+
+	if (accumulated_play_time >= DIFFICULTY_INTERVAL * (locked_rows + 1) && locked_rows + 1 < matrix.get_height())
+	{
+		changed = 1;
+
+		locked_rows++;
+
+		fill_locked_rows();
+	}
+
+	//The keys only do something while a tetromino is falling, but their releases always count.
+	bool active = 0 == clear_effect_timer && 0 == game_over;
+
+	while (1)
+	{
+		while (next_event < event_count && events[next_event].time <= time)
+		{
+			apply_event(events[next_event++]);
+		}
+
+		unsigned short next_time = next_event < event_count ? events[next_event].time : FRAME_DURATION;
+
+		if (1 == active)
+		{
+			//Nothing moves between a hard drop and the lock at the end of the update, but the timers keep running.
+			if (0 == hard_dropped)
+			{
+				changed |= act(hard_dropped);
+			}
+
+			changed |= advance(next_time - time, hard_dropped);
+		}
+
+		time = next_time;
+
+		if (FRAME_DURATION <= time)
+		{
+			break;
+		}
+	}
+
+	previous_keys = i_input.keys;
+
+	if (0 == clear_effect_timer)
+	{
+		if (1 == game_over)
+		{
+			return changed;
+		}
+
+		if (current_fall_speed == fall_timer)
+		{
+			changed = 1;
+
+			if (0 == tetromino.move_down(matrix))
+			{
+				unsigned cleared_now = 0;
+				unsigned mono_cleared = 0;
+
+				pieces_placed++;
+
+				tetromino.update_matrix(matrix);
+
+				//The locked rows at the bottom can never be cleared.
+				for (unsigned char a = 0; a < matrix.get_height() - locked_rows; a++)
+				{
+					if (1 == matrix.is_row_full(a))
+					{
+						cleared_now++;
+
+						if (1 == matrix.is_row_mono(a))
+						{
+							mono_cleared++;
+						}
+
+						clear_effect_timer = CLEAR_EFFECT_DURATION;
+
+						clear_lines[a] = 1;
+					}
+				}
+
+				add_cleared_lines(cleared_now, mono_cleared);
+
+				if (0 == clear_effect_timer)
+				{
+					game_over = 0 == tetromino.reset(piece_queue.pop(*randomizer), matrix);
+				}
+			}
+
+			fall_timer = 0;
+		}
+		else
+		{
+			fall_timer++;
+		}
+	}
+	else
+	{
+		changed = 1;
+
+		clear_effect_timer--;
+
+		if (0 == clear_effect_timer)
+		{
+			//The rows that were marked are exactly the full ones, and the locked rows never move.
+			matrix.clear_full_rows(static_cast<unsigned char>(locked_rows));
+
+			game_over = 0 == tetromino.reset(piece_queue.pop(*randomizer), matrix);
+
+			std::fill(clear_lines.begin(), clear_lines.end(), 0);
+		}
+	}
+
+	return changed;
+}
+
+void GameState::resize(unsigned char i_width, unsigned char i_height)
+{
+	matrix.resize(i_width, i_height);
+
+	clear_lines.assign(matrix.get_height(), 0);
+}
+
+void GameState::update_level_speed()
+{
+	level = (1 == advanced_mode ? 2 : 1) + lines_cleared / 10;
+
+	current_fall_speed = static_cast<unsigned char>(std::max<int>(SOFT_DROP_SPEED, START_FALL_SPEED - static_cast<int>(level - 1)));
+}
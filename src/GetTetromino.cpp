@@ -1,76 +1,11 @@
-#include <vector>
+#include <array>
 
-#include "Headers/Global.hpp"
-#include "Headers/GetTetromino.hpp"
+#include "Global.hpp"
+#include "GetTetromino.hpp"
 
-std::vector<Position> get_tetromino(unsigned char i_shape, unsigned char i_x, unsigned char i_y)
+std::array<Position, 4> get_tetromino(unsigned char i_shape, unsigned char i_x, unsigned char i_y)
 {
-	std::vector<Position> output_tetromino(4);
-
-	switch (i_shape)
-	{
-		case 0:
-		{
-			output_tetromino[0] = {1, -1};
-			output_tetromino[1] = {0, -1};
-			output_tetromino[2] = {-1, -1};
-			output_tetromino[3] = {-2, -1};
-
-			break;
-		}
-		case 1:
-		{
-			output_tetromino[0] = {0, 0};
-			output_tetromino[1] = {1, 0};
-			output_tetromino[2] = {-1, -1};
-			output_tetromino[3] = {-1, 0};
-
-			break;
-		}
-		case 2:
-		{
-			output_tetromino[0] = {0, 0};
-			output_tetromino[1] = {1, 0};
-			output_tetromino[2] = {1, -1};
-			output_tetromino[3] = {-1, 0};
-
-			break;
-		}
-		case 3:
-		{
-			output_tetromino[0] = {0, 0};
-			output_tetromino[1] = {0, -1};
-			output_tetromino[2] = {-1, -1};
-			output_tetromino[3] = {-1, 0};
-
-			break;
-		}
-		case 4:
-		{
-			output_tetromino[0] = {0, 0};
-			output_tetromino[1] = {1, -1};
-			output_tetromino[2] = {0, -1};
-			output_tetromino[3] = {-1, 0};
-
-			break;
-		}
-		case 5:
-		{
-			output_tetromino[0] = {0, 0};
-			output_tetromino[1] = {1, 0};
-			output_tetromino[2] = {0, -1};
-			output_tetromino[3] = {-1, 0};
-
-			break;
-		}
-		case 6:
-		{
-			output_tetromino[0] = {0, 0};
-			output_tetromino[1] = {1, 0};
-			output_tetromino[2] = {0, -1};
-			output_tetromino[3] = {-1, -1};
-		}
-	}
+	std::array<Position, 4> output_tetromino = TETROMINOES[i_shape];
 
 	for (Position& mino : output_tetromino)
 	{
@@ -79,4 +14,4 @@ std::vector<Position> get_tetromino(unsigned char i_shape, unsigned char i_x, un
 	}
 
 	return output_tetromino;
-}
\ No newline at end of file
+}
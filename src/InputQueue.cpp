@@ -0,0 +1,148 @@
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <memory>
+#include <vector>
+
+#include "Global.hpp"
+#include "Board.hpp"
+#include "Tetromino.hpp"
+#include "Randomizer.hpp"
+#include "PieceQueue.hpp"
+#include "GameState.hpp"
+#include "InputQueue.hpp"
+
+InputQueue::InputQueue() :
+	count(0),
+	dropped_keys(0),
+	dropped_state(0),
+	front(0),
+	frame_keys(0),
+	pushed_keys(0)
+{
+	entries.fill({});
+}
+
+unsigned char InputQueue::get_keys() const
+{
+	return pushed_keys;
+}
+
+void InputQueue::drop_front()
+{
+	const Entry& entry = entries[front];
+
+	//The first dropped event of a key starts from where the handed out events left it.
+	if (0 == (dropped_keys & entry.key))
+	{
+		dropped_keys |= entry.key;
+		dropped_state = (dropped_state & ~entry.key) | (frame_keys & entry.key);
+	}
+
+	if (1 == entry.pressed)
+	{
+		dropped_state |= entry.key;
+	}
+	else
+	{
+		dropped_state &= ~entry.key;
+	}
+
+	count--;
+	front = (1 + front) % INPUT_QUEUE_SIZE;
+}
+
+InputFrame InputQueue::pop_frame(const std::chrono::time_point<std::chrono::steady_clock>& i_update_start)
+{
+	InputFrame frame = {};
+
+	std::chrono::time_point<std::chrono::steady_clock> update_end = i_update_start + std::chrono::microseconds(FRAME_DURATION);
+
+	//The dropped events are older than the queued ones, so they come first. Every key has at most 2, so they always fit.
+	for (unsigned char key = 1; 0 != dropped_keys && 0 != key; key <<= 1)
+	{
+		if (0 == (dropped_keys & key))
+		{
+			continue;
+		}
+
+		bool held = 0 != (frame_keys & key);
+		bool tapped = held == (0 != (dropped_state & key));
+
+		//A key that ended up where it started was tapped, so it goes the other way and back.
+		if (1 == tapped)
+		{
+			frame.events[frame.event_count++] = {!held, key, 0};
+		}
+
+		frame.events[frame.event_count++] = {0 != (dropped_state & key), key, 0};
+
+		frame_keys = (frame_keys & ~key) | (dropped_state & key);
+
+		dropped_keys &= ~key;
+	}
+
+	//Whatever doesn't fit waits for the next update.
+	while (0 < count && entries[front].time < update_end && frame.event_count < MAX_INPUT_EVENTS)
+	{
+		const Entry& entry = entries[front];
+
+		long long time = std::chrono::duration_cast<std::chrono::microseconds>(entry.time - i_update_start).count();
+
+		frame.events[frame.event_count++] = {entry.pressed, entry.key, static_cast<unsigned short>(std::clamp<long long>(time, 0, FRAME_DURATION - 1))};
+
+		if (1 == entry.pressed)
+		{
+			frame_keys |= entry.key;
+		}
+		else
+		{
+			frame_keys &= ~entry.key;
+		}
+
+		count--;
+		front = (1 + front) % INPUT_QUEUE_SIZE;
+	}
+
+	frame.keys = frame_keys;
+
+	return frame;
+}
+
+void InputQueue::release_all(const std::chrono::time_point<std::chrono::steady_clock>& i_time)
+{
+	for (unsigned char key = 1; key < INPUT_PAUSE; key <<= 1)
+	{
+		if (0 != (pushed_keys & key))
+		{
+			push(key, 0, i_time);
+		}
+	}
+}
+
+void InputQueue::push(unsigned char i_key, bool i_pressed, const std::chrono::time_point<std::chrono::steady_clock>& i_time)
+{
+	//The OS repeats held keys, and we only care about the first press.
+	if (i_pressed == (0 != (pushed_keys & i_key)))
+	{
+		return;
+	}
+
+	if (1 == i_pressed)
+	{
+		pushed_keys |= i_key;
+	}
+	else
+	{
+		pushed_keys &= ~i_key;
+	}
+
+	if (INPUT_QUEUE_SIZE == count)
+	{
+		drop_front();
+	}
+
+	entries[(front + count) % INPUT_QUEUE_SIZE] = {i_pressed, i_key, i_time};
+
+	count++;
+}
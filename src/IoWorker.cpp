@@ -0,0 +1,86 @@
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+#include "IoWorker.hpp"
+
+IoWorker::IoWorker() :
+	busy(0),
+	stopping(0)
+{
+	thread = std::thread(&IoWorker::work, this);
+}
+
+IoWorker::~IoWorker()
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+
+		stopping = 1;
+	}
+
+	wake_condition.notify_one();
+
+	thread.join();
+}
+
+void IoWorker::work()
+{
+	std::unique_lock<std::mutex> lock(mutex);
+
+	while (1)
+	{
+		wake_condition.wait(lock, [this]()
+		{
+			return 1 == stopping || 0 == tasks.empty();
+		});
+
+		//Stopping only once the queue is empty, so nothing that was saved gets lost.
+		if (1 == tasks.empty())
+		{
+			return;
+		}
+
+		std::function<void()> task = std::move(tasks.front());
+
+		tasks.pop_front();
+
+		busy = 1;
+
+		lock.unlock();
+
+		task();
+
+		lock.lock();
+
+		busy = 0;
+
+		if (1 == tasks.empty())
+		{
+			idle_condition.notify_all();
+		}
+	}
+}
+
+void IoWorker::push(std::function<void()> i_task)
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+
+		tasks.push_back(std::move(i_task));
+	}
+
+	wake_condition.notify_one();
+}
+
+void IoWorker::wait()
+{
+	std::unique_lock<std::mutex> lock(mutex);
+
+	idle_condition.wait(lock, [this]()
+	{
+		return 0 == busy && 1 == tasks.empty();
+	});
+}
@@ -1,72 +1,236 @@
 #include <chrono>
+#include <functional>
+#include <memory>
 #include <random>
 #include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
 #include <fstream>
+#include <initializer_list>
 #include <algorithm>
 #include <array>
-#include <initializer_list>
+#include <atomic>
+#include <condition_variable>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
 #include <vector>
 #include <SFML/Graphics.hpp>
 #include <SFML/Window.hpp>
 
-#include "Headers/DrawText.hpp"
-#include "Headers/Global.hpp"
-#include "Headers/GetTetromino.hpp"
-#include "Headers/GetWallKickData.hpp"
-#include "Headers/Tetromino.hpp"
+#include "DrawText.hpp"
+#include "Global.hpp"
+#include "Board.hpp"
+#include "GetTetromino.hpp"
+#include "Tetromino.hpp"
+#include "Randomizer.hpp"
+#include "PieceQueue.hpp"
+#include "GameState.hpp"
+#include "GameSnapshot.hpp"
+#include "InputQueue.hpp"
+#include "ThreadPool.hpp"
+#include "MoveGenerator.hpp"
+#include "TranspositionTable.hpp"
+#include "Bot.hpp"
+#include "SpriteBatch.hpp"
+#include "TextureAtlas.hpp"
+#include "PlayfieldMesh.hpp"
+#include "TripleBuffer.hpp"
+#include "Profiler.hpp"
+#include "Replay.hpp"
+#include "IoWorker.hpp"
+#include "ScoreLog.hpp"
+#include "MappedFile.hpp"
+#include "AssetLoader.hpp"
+
+static void print_usage(const char* i_program)
+{
+	std::cerr << "Usage: " << i_program << " [--replay FILE] [--profile-csv FILE] [--assets FILE] [--pack-assets FILE] [--randomizer uniform|bag|bag14|history] [--preview N] [--das MS] [--arr MS] [--sdf N] [--weights w1,...,w9] [--board WxH]" << std::endl;
+}
 
-int main()
+int main(int i_argument_count, char** i_arguments)
 {
-	enum class GameState { Menu, HighScores, Help, Playing, Paused, GameOver };
-	GameState state = GameState::Menu;
+	enum class Screen { Menu, HighScores, Help, Playing, Paused, GameOver };
+	Screen screen = Screen::Menu;
 
-	std::vector<unsigned> high_scores(10, 0);
-	auto load_high_scores = [&]() {
+	//Games go into the score log on the I/O worker, so finishing one never waits for the disk.
+	IoWorker io_worker;
+	ScoreLog score_log("scores.log", io_worker);
+	if (!score_log.load())
+	{
+		//The old text file had no modes, so its scores count as beginner games.
 		std::ifstream in("highscores.txt");
-		if (!in.is_open()) return;
-		for (unsigned i = 0; i < high_scores.size() && in; ++i) in >> high_scores[i];
-	};
-	auto save_high_scores = [&]() {
-		std::ofstream out("highscores.txt", std::ios::trunc);
-		for (unsigned i = 0; i < high_scores.size(); ++i)
-		{
-			out << high_scores[i];
-			if (i + 1 != high_scores.size()) out << ' ';
-		}
-	};
-	load_high_scores();
-
-	bool game_over = false;
-	bool hard_drop_pressed = false;
-	bool rotate_pressed = false;
-
-	unsigned lag = 0;
-	unsigned lines_cleared = 0;
-
-	unsigned char clear_effect_timer = 0;
-	unsigned char current_fall_speed = START_FALL_SPEED;
-	unsigned char fall_timer = 0;
-	unsigned char move_timer = 0;
-	unsigned char next_shape;
-	unsigned char soft_drop_timer = 0;
-
-	std::chrono::time_point<std::chrono::steady_clock> previous_time;
-
-	unsigned score = 0;
-	unsigned level = 1;
-	bool advanced_mode = false;
-	unsigned locked_rows = 0;
-	const std::chrono::microseconds difficulty_interval(5 * 60 * 1000000ll);
-	std::chrono::microseconds accumulated_play_time(0);
+		unsigned score = 0;
+		while (in >> score) if (0 < score) score_log.add({0, 0, 0, 0, score, 0, 0});
+	}
+	//Which mode the high score screen shows.
+	unsigned char score_mode = 0;
+
 	bool score_posted = false;
 
 	std::random_device random_device;
 
-	std::default_random_engine random_engine(random_device());
+	GameState game(random_device());
+
+	//The autoplay bot, for demos and soak tests.
+	bool autoplay = false;
+
+	ThreadPool thread_pool(std::thread::hardware_concurrency());
+
+	//With "--weights w1,...,w9", like the ones tetris_batch --optimize prints.
+	BotWeights bot_weights = DEFAULT_BOT_WEIGHTS;
+
+	//Every game that is played gets recorded, so it can be watched or verified later.
+	Replay recording = {};
+	bool recording_active = false;
+
+	//With "--replay <file>" we only watch a recorded game.
+	Replay playback = {};
+	bool playback_active = false;
+	std::size_t playback_event = 0;
+	std::size_t playback_frame = 0;
+
+	//F3 shows the frame time overlay. With "--profile-csv <file>", the recent frames are also saved when the game closes.
+	Profiler profiler;
+	bool show_profiler = false;
+	std::string profile_csv_path;
+
+	//A pack is used if there is one, otherwise the manifest says where every asset is.
+	std::string asset_pack_path = "assets.pak";
+	std::string manifest_path = "assets/manifest.txt";
+	std::string pack_output_path;
+
+	for (int a = 1; a < i_argument_count; a += 2)
+	{
+		std::string argument = i_arguments[a];
+
+		//Every flag takes a value, so one at the end is missing it.
+		if (1 + a == i_argument_count)
+		{
+			print_usage(i_arguments[0]);
+
+			return 1;
+		}
+
+		if (argument == "--replay")
+		{
+			if (!load_replay(i_arguments[1 + a], playback))
+			{
+				std::cerr << "Can't read the replay " << i_arguments[1 + a] << std::endl;
+
+				return 1;
+			}
+
+			playback_active = true;
+		}
+		else if (argument == "--profile-csv")
+		{
+			profile_csv_path = i_arguments[1 + a];
+		}
+		else if (argument == "--assets")
+		{
+			std::string path = i_arguments[1 + a];
+			if (std::filesystem::path(path).extension() == ".pak") asset_pack_path = path;
+			else manifest_path = path;
+		}
+		else if (argument == "--pack-assets")
+		{
+			pack_output_path = i_arguments[1 + a];
+		}
+		else if (argument == "--randomizer")
+		{
+			std::string name = i_arguments[1 + a];
+			if (name == "uniform") game.randomizer_type = RandomizerType::Uniform;
+			else if (name == "bag") game.randomizer_type = RandomizerType::Bag;
+			else if (name == "bag14") game.randomizer_type = RandomizerType::DoubleBag;
+			else if (name == "history") game.randomizer_type = RandomizerType::History;
+			else
+			{
+				std::cerr << "The randomizer should be uniform, bag, bag14 or history" << std::endl;
+
+				return 1;
+			}
+		}
+		else if (argument == "--preview")
+		{
+			game.preview_count = static_cast<unsigned char>(std::clamp(std::atoi(i_arguments[1 + a]), 1, static_cast<int>(MAX_PREVIEW)));
+		}
+		else if (argument == "--das" || argument == "--arr")
+		{
+			//In milliseconds, and 0 for no delay at all.
+			unsigned time = static_cast<unsigned>(1000 * std::max(0.0, std::atof(i_arguments[1 + a])));
+			if (argument == "--das") game.das = time;
+			else game.arr = time;
+		}
+		else if (argument == "--weights")
+		{
+			if (0 == parse_weights(i_arguments[1 + a], bot_weights))
+			{
+				std::cerr << "The weights should be numbers separated by commas" << std::endl;
+
+				return 1;
+			}
+		}
+		else if (argument == "--sdf")
+		{
+			//How many times faster than the starting speed the soft drop is.
+			game.soft_drop_factor = static_cast<unsigned char>(std::clamp(std::atoi(i_arguments[1 + a]), 1, 255));
+		}
+		else if (argument == "--board")
+		{
+			//Like "20x40" for a board 20 columns wide and 40 rows tall.
+			unsigned width = COLUMNS;
+			unsigned height = ROWS;
+			if (2 != std::sscanf(i_arguments[1 + a], "%ux%u", &width, &height))
+			{
+				std::cerr << "The board size should look like 10x20" << std::endl;
+
+				return 1;
+			}
 
-	std::uniform_int_distribution<unsigned short> shape_distribution(0, 6);
+			game.resize(static_cast<unsigned char>(std::min<unsigned>(width, MAX_COLUMNS)), static_cast<unsigned char>(std::min<unsigned>(height, MAX_ROWS)));
+		}
+		else
+		{
+			print_usage(i_arguments[0]);
+
+			return 1;
+		}
+	}
 
-	std::vector<bool> clear_lines(ROWS, false);
+	Bot bot(bot_weights, thread_pool);
+
+	AssetLoader assets;
+	if (!pack_output_path.empty() || !assets.open_pack(asset_pack_path))
+	{
+		assets.load_manifest(manifest_path);
+	}
+
+	if (!pack_output_path.empty())
+	{
+		return assets.save_pack(pack_output_path) ? 0 : 1;
+	}
+
+	//The images and the font are decoded on the pool while the window is being created.
+	assets.start_loading(thread_pool);
+
+	//A replay is always watched on the board it was played on, with the same randomizer and handling.
+	if (playback_active)
+	{
+		game.arr = playback.arr;
+		game.das = playback.das;
+		game.soft_drop_factor = playback.soft_drop_factor;
+		game.randomizer_type = playback.randomizer_type;
+		game.resize(playback.board_width, playback.board_height);
+	}
+
+	game.reset(0, random_device());
+
+	//The size after clamping to what the board supports.
+	unsigned char board_height = game.matrix.get_height();
+	unsigned char board_width = game.matrix.get_width();
 
 	std::vector<sf::Color> cell_colors = {
 		sf::Color(36, 36, 85),
@@ -80,687 +244,779 @@ int main()
 		sf::Color(73, 73, 85)
 	};
 
-	std::vector<std::vector<unsigned char>> matrix(COLUMNS, std::vector<unsigned char>(ROWS));
+	//Big boards are scaled down so that the window still fits on the screen.
+	unsigned char screen_resize = SCREEN_RESIZE;
+	sf::Vector2u desktop_size = sf::VideoMode::getDesktopMode().size;
+	while (1 < screen_resize && (9 * desktop_size.x < 10u * 2 * CELL_SIZE * board_width * screen_resize || 9 * desktop_size.y < 10u * CELL_SIZE * board_height * screen_resize))
+	{
+		screen_resize--;
+	}
 
 	sf::RenderWindow window(
-		sf::VideoMode({static_cast<unsigned int>(2 * CELL_SIZE * COLUMNS * SCREEN_RESIZE),
-					   static_cast<unsigned int>(CELL_SIZE * ROWS * SCREEN_RESIZE)}),
+		sf::VideoMode({static_cast<unsigned int>(2 * CELL_SIZE * board_width * screen_resize),
+					   static_cast<unsigned int>(CELL_SIZE * board_height * screen_resize)}),
 		"Tetris",
 		sf::Style::Close);
 
-	sf::FloatRect view_rect{sf::Vector2f{0.f, 0.f}, sf::Vector2f{static_cast<float>(2 * CELL_SIZE * COLUMNS), static_cast<float>(CELL_SIZE * ROWS)}};
+	//Holding a key is handled by DAS and ARR, so the repeats from the OS aren't needed.
+	window.setKeyRepeatEnabled(false);
+
+	sf::FloatRect view_rect{sf::Vector2f{0.f, 0.f}, sf::Vector2f{static_cast<float>(2 * CELL_SIZE * board_width), static_cast<float>(CELL_SIZE * board_height)}};
 	window.setView(sf::View(view_rect));
 
-	auto load_texture = [](sf::Texture& tex, std::initializer_list<std::string> paths) {
-		for (const auto& p : paths)
-		{
-			if (tex.loadFromFile(p)) return true;
-		}
-		return false;
-	};
+	//Only the upload to the GPU is left for this thread.
+	thread_pool.wait();
+
+	//Every image goes into one texture, so the playfield, the preview and its box are a single draw call.
+	TextureAtlas atlas;
+	for (const char* name : {"background", "frame", "scorebar", "nextbox"})
+	{
+		if (const sf::Image* image = assets.get_image(name)) atlas.add_image(name, *image);
+	}
+	if (const sf::Image* tiles = assets.get_image("tiles")) atlas.add_tiles("tile", *tiles);
+	if (!atlas.build())
+	{
+		std::cerr << "Failed to build the texture atlas" << std::endl;
+	}
+
+	bool has_background = atlas.has_region("background");
+	bool has_frame = atlas.has_region("frame");
+	bool has_scorebar = atlas.has_region("scorebar");
 
-	sf::Texture tex_background;
-	sf::Texture tex_frame;
-	sf::Texture tex_scorebar;
-	sf::Texture tex_nextbox;
+	if (const sf::Font* font = assets.get_font("font"))
+	{
+		set_text_font(*font);
+	}
+	else
+	{
+		std::cerr << "Failed to load any font, check assets/manifest.txt" << std::endl;
+	}
 
-	bool has_background = load_texture(tex_background, {
-		"Resources/Images/background.png",
-		"C:/Users/M.Ahad Ali/Desktop/Tetris Project/Resources/Images/background.png"
-	});
-	bool has_frame = load_texture(tex_frame, {"Resources/Images/frame.png", "Project/img/frame.png"});
-	bool has_scorebar = load_texture(tex_scorebar, {"Resources/Images/Score bar.png", "Project/img/Score bar.png"});
-	bool has_nextbox = load_texture(tex_nextbox, {"Resources/Images/Next tetriminos shown.png", "Project/img/Next tetriminos shown.png"});
+	sf::Vector2f background_size(atlas.get_region("background").size);
+	sf::Vector2f frame_size(atlas.get_region("frame").size);
+	sf::Vector2f scorebar_size(atlas.get_region("scorebar").size);
 
-	sf::Sprite background_sprite(tex_background);
-	sf::Sprite frame_sprite(tex_frame);
-	sf::Sprite scorebar_sprite(tex_scorebar);
-	sf::Sprite nextbox_sprite(tex_nextbox);
+	sf::Sprite background_sprite(atlas.get_texture(), atlas.get_region("background"));
+	sf::Sprite frame_sprite(atlas.get_texture(), atlas.get_region("frame"));
+	sf::Sprite scorebar_sprite(atlas.get_texture(), atlas.get_region("scorebar"));
 
 	if (has_background)
 	{
-		background_sprite.setScale(sf::Vector2f(view_rect.size.x / tex_background.getSize().x, view_rect.size.y / tex_background.getSize().y));
+		background_sprite.setScale(sf::Vector2f(view_rect.size.x / background_size.x, view_rect.size.y / background_size.y));
 		background_sprite.setPosition(sf::Vector2f(0.f, 0.f));
 	}
 	if (has_frame)
 	{
-		float target_w = static_cast<float>(CELL_SIZE * COLUMNS + 4);
-		float target_h = static_cast<float>(CELL_SIZE * ROWS + 4);
-		frame_sprite.setScale(sf::Vector2f(target_w / static_cast<float>(tex_frame.getSize().x), target_h / static_cast<float>(tex_frame.getSize().y)));
+		float target_w = static_cast<float>(CELL_SIZE * board_width + 4);
+		float target_h = static_cast<float>(CELL_SIZE * board_height + 4);
+		frame_sprite.setScale(sf::Vector2f(target_w / frame_size.x, target_h / frame_size.y));
 		frame_sprite.setPosition(sf::Vector2f(-2.f, -2.f));
 	}
 	if (has_scorebar)
 	{
-		scorebar_sprite.setScale(sf::Vector2f((CELL_SIZE * (COLUMNS - 1)) / static_cast<float>(tex_scorebar.getSize().x), (CELL_SIZE * 5) / static_cast<float>(tex_scorebar.getSize().y)));
+		scorebar_sprite.setScale(sf::Vector2f((CELL_SIZE * (board_width - 1)) / scorebar_size.x, (CELL_SIZE * 5) / scorebar_size.y));
+	}
+
+	//With a tile skin the shapes are drawn untinted, each with the tile of its color (I, J, L, O, S, T, Z). The empty cells and the ghost stay flat.
+	const std::array<unsigned char, 7> shape_tiles = {5, 6, 4, 0, 2, 3, 1};
+	std::vector<sf::IntRect> cell_rects(cell_colors.size(), atlas.get_region("white"));
+	for (unsigned char shape = 0; shape < shape_tiles.size(); shape++)
+	{
+		std::string tile = "tile" + std::to_string(shape_tiles[shape]);
+		if (!atlas.has_region(tile)) continue;
+		cell_rects[1 + shape] = atlas.get_region(tile);
+		cell_colors[1 + shape] = sf::Color::White;
 	}
-	if (has_nextbox)
+
+	PlayfieldMesh playfield_mesh(atlas, cell_colors, cell_rects);
+
+	unsigned short modal_w = static_cast<unsigned short>(CELL_SIZE * board_width);
+	unsigned short modal_h = static_cast<unsigned short>(CELL_SIZE * ((board_height / 2) + 1));
+	unsigned short modal_x = static_cast<unsigned short>(0.5f * CELL_SIZE * board_width - 0.5f * modal_w);
+	unsigned short modal_y = static_cast<unsigned short>(0.5f * CELL_SIZE * board_height - 0.5f * modal_h);
+
+	sf::RectangleShape playfield_border(sf::Vector2f(static_cast<float>(CELL_SIZE * board_width), static_cast<float>(CELL_SIZE * board_height)));
+	playfield_border.setPosition(sf::Vector2f(0.f, 0.f));
+	playfield_border.setFillColor(sf::Color(18, 18, 28));
+	playfield_border.setOutlineThickness(2.f);
+	playfield_border.setOutlineColor(sf::Color(80, 80, 130));
+
+	float side_x = static_cast<float>(CELL_SIZE * (board_width + 0.05f));
+	float side_y = 4.f;
+	float side_w = static_cast<float>(CELL_SIZE * (board_width - 0.25f));
+	float side_h = static_cast<float>(CELL_SIZE * board_height - 8.f);
+
+	sf::RectangleShape side_panel(sf::Vector2f(side_w, side_h));
+	side_panel.setPosition(sf::Vector2f(side_x, side_y));
+	side_panel.setFillColor(sf::Color(12, 12, 20, 230));
+	side_panel.setOutlineThickness(2.f);
+	side_panel.setOutlineColor(sf::Color(70, 70, 110));
+
+	float next_block_h = static_cast<float>(4 * CELL_SIZE + 14);
+	sf::RectangleShape next_panel(sf::Vector2f(side_w - 8.f, next_block_h));
+	next_panel.setPosition(sf::Vector2f(side_x + 4.f, side_y + 4.f));
+	next_panel.setFillColor(sf::Color(8, 8, 14, 230));
+	next_panel.setOutlineThickness(1.5f);
+	next_panel.setOutlineColor(sf::Color(90, 90, 140));
+
+	sf::RectangleShape stats_panel(sf::Vector2f(side_w - 8.f, side_h - next_block_h - 10.f));
+	stats_panel.setPosition(sf::Vector2f(side_x + 4.f, side_y + next_block_h + 6.f));
+	stats_panel.setFillColor(sf::Color(10, 10, 16, 230));
+	stats_panel.setOutlineThickness(1.5f);
+	stats_panel.setOutlineColor(sf::Color(70, 70, 110));
+
+	sf::RectangleShape preview_border(sf::Vector2f(static_cast<float>(5 * CELL_SIZE), static_cast<float>(4 * CELL_SIZE)));
+	preview_border.setFillColor(sf::Color(6, 6, 12));
+	preview_border.setOutlineThickness(1.f);
+	preview_border.setOutlineColor(sf::Color(90, 90, 140));
+	preview_border.setPosition(sf::Vector2f(next_panel.getPosition().x + 10.f, next_panel.getPosition().y + 16.f));
+
+	//The shapes after the next one go down the rest of the next panel, to the right of the preview box.
+	float queue_x = preview_border.getPosition().x + preview_border.getSize().x + 4.f;
+	sf::FloatRect preview_queue_area(sf::Vector2f(queue_x, next_panel.getPosition().y + 4.f), sf::Vector2f(std::max(0.f, next_panel.getPosition().x + next_panel.getSize().x - 4.f - queue_x), next_panel.getSize().y - 8.f));
+
+	sf::RectangleShape modal_shadow(sf::Vector2f(static_cast<float>(modal_w + 12), static_cast<float>(modal_h + 12)));
+	modal_shadow.setPosition(sf::Vector2f(static_cast<float>(modal_x - 6), static_cast<float>(modal_y - 6)));
+	modal_shadow.setFillColor(sf::Color(0, 0, 0, 170));
+
+	sf::RectangleShape modal_back(sf::Vector2f(static_cast<float>(modal_w), static_cast<float>(modal_h)));
+	modal_back.setPosition(sf::Vector2f(static_cast<float>(modal_x), static_cast<float>(modal_y)));
+	modal_back.setFillColor(sf::Color(16, 18, 30, 235));
+	modal_back.setOutlineThickness(2.5f);
+	modal_back.setOutlineColor(sf::Color(90, 200, 255));
+
+	sf::RectangleShape backdrop(sf::Vector2f(view_rect.size.x, view_rect.size.y));
+	backdrop.setFillColor(sf::Color(8, 10, 18));
+
+	if (has_frame)
+	{
+		frame_sprite.setPosition(sf::Vector2f(0.f, 0.f));
+	}
+	if (has_scorebar)
 	{
-		nextbox_sprite.setScale(sf::Vector2f((CELL_SIZE * 5) / static_cast<float>(tex_nextbox.getSize().x), (CELL_SIZE * 5) / static_cast<float>(tex_nextbox.getSize().y)));
+		scorebar_sprite.setPosition(sf::Vector2f(stats_panel.getPosition().x + 4.f, stats_panel.getPosition().y + 4.f));
 	}
 
-	auto generate_shape = [&]() -> unsigned char {
-		if (advanced_mode)
+	//Every draw goes through here so that the profiler can count them.
+	auto draw = [&](sf::RenderTarget& target, const sf::Drawable& drawable) {
+		target.draw(drawable);
+		profiler.count_draw_call();
+	};
+	auto draw_string = [&](unsigned short x, unsigned short y, const std::string& text) {
+		draw_text(x, y, text, window);
+		profiler.count_draw_call();
+	};
+
+	sf::RectangleShape profiler_back(sf::Vector2f(static_cast<float>(CELL_SIZE * board_width), 64.f));
+	profiler_back.setFillColor(sf::Color(0, 0, 0, 200));
+
+	//Everything behind the playfield that never changes during a game.
+	auto draw_panels = [&](sf::RenderTarget& target) {
+		draw(target, backdrop);
+		// vignette overlay for depth
+		draw(target, playfield_border);
+		if (has_frame)
 		{
-			return static_cast<unsigned char>(shape_distribution(random_engine));
+			draw(target, frame_sprite);
+		}
+		draw(target, side_panel);
+		draw(target, next_panel);
+		draw(target, preview_border);
+		draw(target, stats_panel);
+		if (has_scorebar)
+		{
+			draw(target, scorebar_sprite);
 		}
-		std::uniform_int_distribution<int> basic_dist(0, 3);
-		return static_cast<unsigned char>(basic_dist(random_engine));
 	};
 
-	Tetromino tetromino(generate_shape(), matrix);
+	//The panels are drawn once, at the window resolution, into a texture that we composite every frame.
+	sf::RenderTexture panels_texture;
+	bool has_panels_texture = panels_texture.resize({static_cast<unsigned int>(view_rect.size.x * screen_resize), static_cast<unsigned int>(view_rect.size.y * screen_resize)});
+	if (has_panels_texture)
+	{
+		panels_texture.setView(sf::View(view_rect));
+		draw_panels(panels_texture);
+		panels_texture.display();
+	}
 
-	next_shape = generate_shape();
+	sf::Sprite panels_sprite(panels_texture.getTexture());
+	panels_sprite.setScale(sf::Vector2f(1.f / screen_resize, 1.f / screen_resize));
 
-	auto fill_locked_rows = [&]() {
-		for (unsigned char row = 0; row < locked_rows; ++row)
-		{
-			unsigned char target = static_cast<unsigned char>(ROWS - 1 - row);
-			for (unsigned char col = 0; col < COLUMNS; ++col)
-			{
-				matrix[col][target] = 8;
-			}
-		}
+	bool redraw = true;
+
+
+	auto finish_recording = [&]() {
+		if (!recording_active) return;
+		recording_active = false;
+		recording.final_lines = game.lines_cleared;
+		recording.final_score = game.score;
+		std::string path = "replays/replay_" + std::to_string(std::chrono::duration_cast<std::chrono::seconds>(std::chrono::system_clock::now().time_since_epoch()).count()) + ".trp";
+		io_worker.push([path, replay = recording]() {
+			std::error_code error;
+			std::filesystem::create_directories("replays", error);
+			save_replay(path, replay);
+		});
 	};
 
 	auto reset_game = [&](bool adv) {
-		advanced_mode = adv;
-		score = 0;
-		lines_cleared = 0;
-		level = adv ? 2 : 1;
-		current_fall_speed = static_cast<unsigned char>(std::max<int>(SOFT_DROP_SPEED, START_FALL_SPEED - (level - 1)));
-		fall_timer = 0;
-		move_timer = 0;
-		soft_drop_timer = 0;
-		clear_effect_timer = 0;
-		game_over = false;
+		finish_recording();
+		playback_active = false;
+		unsigned seed = random_device();
+		game.reset(adv, seed);
+		bot.reset();
+		score_mode = adv;
 		score_posted = false;
-		locked_rows = 0;
-		for (auto& col : matrix) std::fill(col.begin(), col.end(), 0);
-		std::fill(clear_lines.begin(), clear_lines.end(), 0);
-		fill_locked_rows();
-		tetromino = Tetromino(generate_shape(), matrix);
-		next_shape = generate_shape();
-		accumulated_play_time = std::chrono::microseconds(0);
+		recording = {adv, board_height, board_width, game.soft_drop_factor, game.arr, game.das, 0, 0, seed, game.randomizer_type, {}, {}};
+		recording_active = true;
 	};
 
-	auto update_level_speed = [&]() {
-		level = (advanced_mode ? 2u : 1u) + lines_cleared / 10;
-		current_fall_speed = static_cast<unsigned char>(std::max<int>(SOFT_DROP_SPEED, START_FALL_SPEED - static_cast<int>(level - 1)));
-	};
+	if (playback_active)
+	{
+		game.reset(playback.advanced_mode, playback.seed);
+		score_mode = playback.advanced_mode;
+		//Nothing from a replay counts as a new score.
+		score_posted = true;
+		screen = Screen::Playing;
+	}
 
 	auto try_post_score = [&]() {
 		if (score_posted) return;
-		high_scores.push_back(score);
-		std::sort(high_scores.begin(), high_scores.end(), std::greater<unsigned>());
-		if (high_scores.size() > 10) high_scores.resize(10);
-		save_high_scores();
+		//Posted after the recording is finished, so the hash is the one of the saved replay.
+		ScoreRecord record = {};
+		record.mode = game.advanced_mode;
+		record.duration = static_cast<unsigned>(std::chrono::duration_cast<std::chrono::milliseconds>(game.accumulated_play_time).count());
+		record.level = game.level;
+		record.lines = game.lines_cleared;
+		record.score = game.score;
+		record.replay_hash = hash_replay(recording);
+		record.time = std::chrono::duration_cast<std::chrono::seconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+		score_log.add(record);
 		score_posted = true;
 	};
 
-	previous_time = std::chrono::steady_clock::now();
-
-	while (window.isOpen())
+	//Only this thread touches the game. After every update that changed something it hands the render thread a copy of what to draw.
+	struct RenderFrame
 	{
-		unsigned delta_time = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - previous_time).count();
+		bool autoplay = false;
+		bool show_profiler = false;
+		Screen screen = Screen::Menu;
+		//Bumped every time a key press gets its first visible response, at input_time.
+		unsigned input_sequence = 0;
+		//Totals since the start. The render thread reports the difference between the frames it draws.
+		unsigned late_updates = 0;
+		unsigned updates = 0;
+		std::chrono::microseconds update_time{0};
+		std::chrono::time_point<std::chrono::steady_clock> input_time;
+		unsigned char score_mode;
+		std::vector<ScoreRecord> high_scores;
+		GameSnapshot game;
+	};
 
-		lag += delta_time;
+	TripleBuffer<RenderFrame> frames;
 
-		previous_time += std::chrono::microseconds(delta_time);
+	std::atomic<bool> running(true);
 
-		while (FRAME_DURATION <= lag)
+	//The game keys, and the input bit of each.
+	auto get_input_key = [](sf::Keyboard::Scancode i_scancode) -> unsigned char {
+		switch (i_scancode)
 		{
-			lag -= FRAME_DURATION;
+			case sf::Keyboard::Scancode::Z: return INPUT_ROTATE_CCW;
+			case sf::Keyboard::Scancode::C: return INPUT_ROTATE_CW;
+			case sf::Keyboard::Scancode::Left: return INPUT_LEFT;
+			case sf::Keyboard::Scancode::Right: return INPUT_RIGHT;
+			case sf::Keyboard::Scancode::Down: return INPUT_SOFT_DROP;
+			case sf::Keyboard::Scancode::Space: return INPUT_HARD_DROP;
+			default: return 0;
+		}
+	};
 
-			while (auto ev = window.pollEvent())
+	InputQueue input_queue;
+
+	//When the last game key was pressed, until the game responds to it.
+	bool input_pending = false;
+	std::chrono::time_point<std::chrono::steady_clock> input_press_time;
+	unsigned input_sequence = 0;
+
+	unsigned late_updates = 0;
+	unsigned updates = 0;
+	std::chrono::microseconds update_time(0);
+
+	//The render thread sleeps on this until there's a new frame or the game is closing, instead of polling for one.
+	bool frame_published = false;
+	std::condition_variable frame_condition;
+	std::mutex frame_mutex;
+
+	auto publish_frame = [&]() {
+		RenderFrame& frame = frames.get_back();
+		frame.autoplay = autoplay;
+		frame.show_profiler = show_profiler;
+		frame.screen = screen;
+		frame.input_sequence = input_sequence;
+		frame.late_updates = late_updates;
+		frame.updates = updates;
+		frame.update_time = update_time;
+		frame.input_time = input_press_time;
+		frame.score_mode = score_mode;
+		score_log.get_table(score_mode, frame.high_scores);
+		take_snapshot(game, frame.game);
+		frames.publish();
+		{
+			std::lock_guard<std::mutex> lock(frame_mutex);
+			frame_published = true;
+		}
+		frame_condition.notify_one();
+	};
+
+	//Draws the latest frame whenever there's a new one, so a slow display never holds up the input or the updates.
+	auto render_loop = [&]() {
+		if (!window.setActive(true))
+		{
+			std::cerr << "Can't draw from the render thread" << std::endl;
+			running = false;
+			return;
+		}
+
+		unsigned shown_input_sequence = 0;
+		unsigned shown_late_updates = 0;
+		unsigned shown_updates = 0;
+		std::chrono::microseconds shown_update_time(0);
+
+		while (running)
+		{
 			{
-				if (ev->is<sf::Event::Closed>())
+				std::unique_lock<std::mutex> lock(frame_mutex);
+				frame_condition.wait(lock, [&]() { return frame_published || !running; });
+				frame_published = false;
+			}
+
+			if (!running || !frames.read())
+			{
+				continue;
+			}
+
+			RenderFrame& frame = frames.get_front();
+			GameSnapshot& snapshot = frame.game;
+
+			profiler.begin_frame();
+			profiler.add_updates(static_cast<unsigned short>(frame.updates - shown_updates), static_cast<unsigned short>(frame.late_updates - shown_late_updates), frame.update_time - shown_update_time);
+			shown_late_updates = frame.late_updates;
+			shown_updates = frame.updates;
+			shown_update_time = frame.update_time;
+
+			profiler.begin_section();
+
+			window.clear();
+
+			unsigned total_seconds = static_cast<unsigned>(snapshot.accumulated_play_time.count() / 1000000);
+			unsigned minutes = total_seconds / 60;
+			unsigned seconds = total_seconds % 60;
+			std::string time_text = std::to_string(minutes) + ":" + (seconds < 10 ? std::string("0") : std::string("")) + std::to_string(seconds);
+
+			auto draw_playfield = [&](bool draw_active_piece, bool show_background, bool draw_ui) {
+				if (draw_ui)
 				{
-					window.close();
+					if (has_panels_texture)
+					{
+						draw(window, panels_sprite);
+					}
+					else
+					{
+						draw_panels(window);
+					}
 				}
-				else if (auto keyRel = ev->getIf<sf::Event::KeyReleased>())
+				else
 				{
-					switch (state)
+					if (show_background && has_background)
 					{
-						case GameState::Playing:
-						case GameState::Paused:
-						{
-							if (keyRel->scancode == sf::Keyboard::Scancode::P)
-							{
-								state = (state == GameState::Playing) ? GameState::Paused : GameState::Playing;
-								break;
-							}
-							if (keyRel->scancode == sf::Keyboard::Scancode::Enter)
-							{
-								state = GameState::Menu;
-								break;
-							}
+						draw(window, background_sprite);
+					}
+					else
+					{
+						draw(window, backdrop);
+					}
 
-							if (state == GameState::Paused)
-							{
-								switch (keyRel->scancode)
-								{
-									case sf::Keyboard::Scancode::Num1:
-										reset_game(false);
-										state = GameState::Playing;
-										break;
-									case sf::Keyboard::Scancode::Num2:
-										reset_game(true);
-										state = GameState::Playing;
-										break;
-									case sf::Keyboard::Scancode::Num3:
-										state = GameState::HighScores;
-										break;
-									case sf::Keyboard::Scancode::Num4:
-										state = GameState::Help;
-										break;
-									case sf::Keyboard::Scancode::Num5:
-										state = GameState::Playing;
-										break;
-									default:
-										break;
-								}
-								break;
-							}
+					return;
+				}
 
-							// gameplay key releases
-							switch (keyRel->scancode)
+				//The matrix, the ghost, the active tetromino, the clear effect and the preview of every upcoming shape with its box in one draw call
+				playfield_mesh.update(snapshot, draw_active_piece, preview_border.getPosition(), preview_border.getSize(), preview_queue_area);
+				draw(window, playfield_mesh);
+
+				if (draw_active_piece)
+				{
+					draw_label(static_cast<unsigned short>(next_panel.getPosition().x + 6.f), static_cast<unsigned short>(next_panel.getPosition().y + 4.f), "Next");
+				}
+			};
+
+			switch (frame.screen)
+			{
+				case Screen::Menu:
+				{
+					draw_playfield(false, true, false);
+					draw(window, modal_shadow);
+					draw(window, modal_back);
+					unsigned short menu_y = static_cast<unsigned short>(modal_y + 12);
+					draw_label(static_cast<unsigned short>(modal_x + 12), menu_y, "TETRIS\n\n1) Beginner\n2) Advanced\n3) High Scores\n4) Help\n5) Quit");
+					break;
+				}
+				case Screen::HighScores:
+				{
+					draw_playfield(false, false, false);
+					draw(window, modal_shadow);
+					draw(window, modal_back);
+					std::string scores_text = std::string("High Scores: ") + (frame.score_mode ? "Advanced" : "Beginner") + "\n";
+					for (std::size_t i = 0; i < frame.high_scores.size(); ++i)
+					{
+						scores_text += std::to_string(i + 1) + ". " + std::to_string(frame.high_scores[i].score) + "\n";
+					}
+					scores_text += "\nLeft/Right: Mode\nAny other key to return";
+					unsigned short hs_y = static_cast<unsigned short>(modal_y + 12);
+					draw_string(static_cast<unsigned short>(modal_x + 12), hs_y, scores_text);
+					break;
+				}
+				case Screen::Help:
+				{
+					draw_playfield(false, false, false);
+					draw(window, modal_shadow);
+					draw(window, modal_back);
+					std::string help_text = "Help\nLeft/Right: Move\nZ/C: Rotate\nDown: Soft drop\nSpace: Hard drop\nP: Pause\nA: Autoplay\nF3: Profiler\nEnter: Menu (post game)\n\nAny key to return";
+					unsigned short help_y = static_cast<unsigned short>(modal_y + 12);
+					draw_label(static_cast<unsigned short>(modal_x + 12), help_y, help_text);
+					break;
+				}
+				case Screen::Paused:
+				case Screen::Playing:
+				case Screen::GameOver:
+				{
+					unsigned short ui_x = static_cast<unsigned short>(stats_panel.getPosition().x + 4.f);
+					unsigned short ui_y = static_cast<unsigned short>(stats_panel.getPosition().y + 6.f);
+					draw_playfield(frame.screen != Screen::GameOver, false, true);
+
+					std::string stats = "Score: " + std::to_string(snapshot.score) +
+						"\nLines: " + std::to_string(snapshot.lines_cleared) +
+						"\nLevel: " + std::to_string(snapshot.level) +
+						"\nSpeed: " + std::to_string(START_FALL_SPEED / snapshot.current_fall_speed) + "x" +
+						"\nLocked: " + std::to_string(snapshot.locked_rows) +
+						"\nTime: " + time_text +
+						"\nMode: " + std::string(snapshot.advanced_mode ? "Advanced" : "Beginner") + std::string(frame.autoplay ? " (Bot)" : "") +
+						"\nBest: " + std::to_string(frame.high_scores.empty() ? 0 : frame.high_scores.front().score);
+					draw_string(ui_x, ui_y, stats);
+
+					if (frame.screen == Screen::Paused)
+					{
+						draw(window, modal_back);
+						draw_label(static_cast<unsigned short>(modal_x + 8), static_cast<unsigned short>(modal_y + 8), "Paused\n1) Beginner\n2) Advanced\n3) High Scores\n4) Help\n5) Continue\nEnter for menu");
+					}
+					else if (frame.screen == Screen::GameOver)
+					{
+						draw(window, modal_back);
+						draw_string(static_cast<unsigned short>(modal_x + 8), static_cast<unsigned short>(modal_y + 8), "Game Over\nScore:" + std::to_string(snapshot.score) + "\nEnter for menu");
+					}
+					break;
+				}
+			}
+
+			//Under the profiler, which covers the top of the modal.
+			draw_labels(window);
+			profiler.count_draw_call();
+
+			if (frame.show_profiler)
+			{
+				draw(window, profiler_back);
+				draw_string(2, 2, profiler.get_overlay_text());
+			}
+
+			window.display();
+
+			profiler.end_render();
+
+			if (frame.input_sequence != shown_input_sequence)
+			{
+				shown_input_sequence = frame.input_sequence;
+				profiler.set_input_latency(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - frame.input_time));
+			}
+		}
+
+		(void)window.setActive(false);
+	};
+
+	//The render thread takes over the window's OpenGL context. The events still have to be handled on this thread, the one that made the window.
+	publish_frame();
+	(void)window.setActive(false);
+	std::thread render_thread(render_loop);
+
+	//When the next fixed update starts. Every key event falls inside the update that covers its time.
+	std::chrono::time_point<std::chrono::steady_clock> update_start_time = std::chrono::steady_clock::now();
+
+	while (running)
+	{
+		//Events are read as soon as they arrive instead of once per update, since SFML doesn't say when they happened.
+		while (auto ev = window.pollEvent())
+		{
+			std::chrono::time_point<std::chrono::steady_clock> event_time = std::chrono::steady_clock::now();
+
+			redraw = true;
+
+			if (ev->is<sf::Event::Closed>())
+			{
+				running = false;
+			}
+			else if (ev->is<sf::Event::FocusLost>())
+			{
+				input_queue.release_all(event_time);
+			}
+			else if (auto keyPress = ev->getIf<sf::Event::KeyPressed>())
+			{
+				unsigned char key = get_input_key(keyPress->scancode);
+
+				if (0 != key)
+				{
+					input_queue.push(key, 1, event_time);
+
+					//Only the keys that move the piece are timed, and only when a person is playing.
+					if (screen == Screen::Playing && !autoplay && !playback_active && !input_pending)
+					{
+						input_pending = true;
+						input_press_time = event_time;
+					}
+				}
+			}
+			else if (auto keyRel = ev->getIf<sf::Event::KeyReleased>())
+			{
+				unsigned char key = get_input_key(keyRel->scancode);
+
+				if (0 != key)
+				{
+					input_queue.push(key, 0, event_time);
+				}
+
+				if (keyRel->scancode == sf::Keyboard::Scancode::F3)
+				{
+					show_profiler = !show_profiler;
+					continue;
+				}
+
+				switch (screen)
+				{
+					case Screen::Playing:
+					case Screen::Paused:
+					{
+						if (keyRel->scancode == sf::Keyboard::Scancode::P)
+						{
+							if (screen == Screen::Playing && recording_active && !recording.inputs.empty())
 							{
-								case sf::Keyboard::Scancode::Z:
-								case sf::Keyboard::Scancode::C:
-									rotate_pressed = 0;
-									break;
-								case sf::Keyboard::Scancode::Down:
-									soft_drop_timer = 0;
-									break;
-								case sf::Keyboard::Scancode::Left:
-								case sf::Keyboard::Scancode::Right:
-									move_timer = 0;
-									break;
-								case sf::Keyboard::Scancode::Space:
-									hard_drop_pressed = 0;
-									break;
-								default:
-									break;
+								recording.inputs.back() |= INPUT_PAUSE;
 							}
+							screen = (screen == Screen::Playing) ? Screen::Paused : Screen::Playing;
 							break;
 						}
-						case GameState::GameOver:
+						if (keyRel->scancode == sf::Keyboard::Scancode::Enter)
 						{
-							if (keyRel->scancode == sf::Keyboard::Scancode::Enter)
-							{
-								state = GameState::Menu;
-							}
+							screen = Screen::Menu;
+							break;
+						}
+						if (keyRel->scancode == sf::Keyboard::Scancode::A && screen == Screen::Playing && !playback_active)
+						{
+							autoplay = !autoplay;
+							bot.reset();
 							break;
 						}
-						case GameState::Menu:
+
+						if (screen == Screen::Paused)
 						{
 							switch (keyRel->scancode)
 							{
 								case sf::Keyboard::Scancode::Num1:
 									reset_game(false);
-									state = GameState::Playing;
+									screen = Screen::Playing;
 									break;
 								case sf::Keyboard::Scancode::Num2:
 									reset_game(true);
-									state = GameState::Playing;
+									screen = Screen::Playing;
 									break;
 								case sf::Keyboard::Scancode::Num3:
-									state = GameState::HighScores;
+									screen = Screen::HighScores;
 									break;
 								case sf::Keyboard::Scancode::Num4:
-									state = GameState::Help;
+									screen = Screen::Help;
 									break;
 								case sf::Keyboard::Scancode::Num5:
-									window.close();
+									screen = Screen::Playing;
 									break;
 								default:
 									break;
 							}
-							break;
-						}
-						case GameState::HighScores:
-						case GameState::Help:
-						{
-							// any key to return to menu
-							state = GameState::Menu;
-							break;
 						}
+						break;
 					}
-				}
-			}
-
-		
-			if (state == GameState::Playing)
-			{
-				accumulated_play_time += std::chrono::microseconds(FRAME_DURATION);
-				if (accumulated_play_time >= difficulty_interval * (locked_rows + 1) && locked_rows + 1 < ROWS)
-				{
-					locked_rows++;
-					fill_locked_rows();
-				}
-
-				if (0 == clear_effect_timer)
-				{
-					if (0 == game_over)
+					case Screen::GameOver:
 					{
-						if (0 == rotate_pressed)
+						if (keyRel->scancode == sf::Keyboard::Scancode::Enter)
 						{
-							if (sf::Keyboard::isKeyPressed(sf::Keyboard::Scancode::Z))
-							{
-								rotate_pressed = 1;
-								tetromino.rotate(false, matrix);
-							}
-							else if (sf::Keyboard::isKeyPressed(sf::Keyboard::Scancode::C))
-							{
-								rotate_pressed = 1;
-								tetromino.rotate(true, matrix);
-							}
+							screen = Screen::Menu;
 						}
-
-						if (0 == move_timer)
-						{
-							if (sf::Keyboard::isKeyPressed(sf::Keyboard::Scancode::Left))
-							{
-								move_timer = 1;
-								tetromino.move_left(matrix);
-							}
-							else if (sf::Keyboard::isKeyPressed(sf::Keyboard::Scancode::Right))
-							{
-								move_timer = 1;
-								tetromino.move_right(matrix);
-							}
-						}
-						else
-						{
-							move_timer = static_cast<unsigned char>((1 + move_timer) % MOVE_SPEED);
-						}
-
-						if (0 == hard_drop_pressed && sf::Keyboard::isKeyPressed(sf::Keyboard::Scancode::Space))
-						{
-							hard_drop_pressed = 1;
-							fall_timer = current_fall_speed;
-							tetromino.hard_drop(matrix);
-						}
-
-						if (0 == soft_drop_timer)
-						{
-							if (sf::Keyboard::isKeyPressed(sf::Keyboard::Scancode::Down))
-							{
-								if (tetromino.move_down(matrix))
-								{
-									fall_timer = 0;
-									soft_drop_timer = 1;
-								}
-							}
-						}
-						else
+						break;
+					}
+					case Screen::Menu:
+					{
+						switch (keyRel->scancode)
 						{
-							soft_drop_timer = static_cast<unsigned char>((1 + soft_drop_timer) % SOFT_DROP_SPEED);
+							case sf::Keyboard::Scancode::Num1:
+								reset_game(false);
+								screen = Screen::Playing;
+								break;
+							case sf::Keyboard::Scancode::Num2:
+								reset_game(true);
+								screen = Screen::Playing;
+								break;
+							case sf::Keyboard::Scancode::Num3:
+								screen = Screen::HighScores;
+								break;
+							case sf::Keyboard::Scancode::Num4:
+								screen = Screen::Help;
+								break;
+							case sf::Keyboard::Scancode::Num5:
+								running = false;
+								break;
+							default:
+								break;
 						}
-
-						if (current_fall_speed == fall_timer)
+						break;
+					}
+					case Screen::HighScores:
+					{
+						if (keyRel->scancode == sf::Keyboard::Scancode::Left || keyRel->scancode == sf::Keyboard::Scancode::Right)
 						{
-							if (!tetromino.move_down(matrix))
-							{
-								tetromino.update_matrix(matrix);
-
-								unsigned cleared_now = 0;
-								unsigned mono_cleared = 0;
-								for (unsigned char a = 0; a < ROWS; a++)
-								{
-									if (a >= ROWS - locked_rows) continue;
-									bool clear_line = true;
-									bool mono_line = true;
-									unsigned char first_color = 0;
-									for (unsigned char b = 0; b < COLUMNS; b++)
-									{
-										if (0 == matrix[b][a])
-										{
-											clear_line = false;
-											break;
-										}
-
-										if (first_color == 0)
-										{
-											first_color = matrix[b][a];
-										}
-										else if (matrix[b][a] != first_color)
-										{
-											mono_line = false;
-										}
-									}
-
-									if (clear_line)
-									{
-										lines_cleared++;
-										cleared_now++;
-										if (mono_line) mono_cleared++;
-										clear_effect_timer = CLEAR_EFFECT_DURATION;
-										clear_lines[a] = true;
-									}
-								}
-
-								if (cleared_now)
-								{
-									static const unsigned score_table[4] = {10, 30, 60, 100};
-									unsigned base = score_table[std::min<unsigned>(cleared_now, 4) - 1];
-									unsigned mono_bonus = 20 * mono_cleared;
-									score += (base + mono_bonus) * level;
-									update_level_speed();
-								}
-
-								if (0 == clear_effect_timer)
-								{
-									game_over = (0 == tetromino.reset(next_shape, matrix));
-									next_shape = generate_shape();
-									if (game_over)
-									{
-										state = GameState::GameOver;
-										try_post_score();
-									}
-								}
-							}
-
-							fall_timer = 0;
+							score_mode = (1 + score_mode) % SCORE_MODE_COUNT;
 						}
 						else
 						{
-							fall_timer++;
+							screen = Screen::Menu;
 						}
+						break;
 					}
-				}
-				else
-				{
-					clear_effect_timer--;
-					if (0 == clear_effect_timer)
+					case Screen::Help:
 					{
-						for (unsigned char a = 0; a < ROWS; a++)
-						{
-							if (1 == clear_lines[a])
-							{
-								for (unsigned char b = 0; b < COLUMNS; b++)
-								{
-									matrix[b][a] = 0;
-									for (unsigned char c = a; c > 0; c--)
-									{
-										matrix[b][c] = matrix[b][c - 1];
-										matrix[b][c - 1] = 0;
-									}
-								}
-							}
-						}
-
-						game_over = 0 == tetromino.reset(next_shape, matrix);
-						next_shape = generate_shape();
-						std::fill(clear_lines.begin(), clear_lines.end(), 0);
+						// any key to return to menu
+						screen = Screen::Menu;
+						break;
 					}
 				}
 			}
+		}
+
+		//Anything after the first update in a pass means the loop fell behind.
+		bool catching_up = false;
 
-			//Here we're drawing everything!
-			if (FRAME_DURATION > lag)
+		while (update_start_time + std::chrono::microseconds(FRAME_DURATION) <= std::chrono::steady_clock::now())
+		{
+			std::chrono::time_point<std::chrono::steady_clock> update_start = std::chrono::steady_clock::now();
+
+			//The queue is emptied even when nobody is playing, so it always knows which keys are held.
+			InputFrame queued_input = input_queue.pop_frame(update_start_time);
+
+			update_start_time += std::chrono::microseconds(FRAME_DURATION);
+
+			if (screen == Screen::Playing)
 			{
-				window.clear();
-
-				unsigned short center_x = static_cast<unsigned short>(0.5f * CELL_SIZE * COLUMNS);
-				unsigned short center_y = static_cast<unsigned short>(0.5f * CELL_SIZE * ROWS);
-				unsigned short modal_w = static_cast<unsigned short>(CELL_SIZE * COLUMNS);
-				unsigned short modal_h = static_cast<unsigned short>(CELL_SIZE * ((ROWS / 2) + 1));
-				unsigned short modal_x = static_cast<unsigned short>(0.5f * CELL_SIZE * COLUMNS - 0.5f * modal_w);
-				unsigned short modal_y = static_cast<unsigned short>(0.5f * CELL_SIZE * ROWS - 0.5f * modal_h);
-
-				unsigned total_seconds = static_cast<unsigned>(accumulated_play_time.count() / 1000000);
-				unsigned minutes = total_seconds / 60;
-				unsigned seconds = total_seconds % 60;
-				std::string time_text = std::to_string(minutes) + ":" + (seconds < 10 ? std::string("0") : std::string("")) + std::to_string(seconds);
-
-				unsigned char clear_cell_size = static_cast<unsigned char>(2 * std::round(0.5f * CELL_SIZE * (clear_effect_timer / static_cast<float>(CLEAR_EFFECT_DURATION))));
-
-				sf::RectangleShape cell(sf::Vector2f(static_cast<float>(CELL_SIZE - 1), static_cast<float>(CELL_SIZE - 1)));
-				sf::RectangleShape playfield_border(sf::Vector2f(static_cast<float>(CELL_SIZE * COLUMNS), static_cast<float>(CELL_SIZE * ROWS)));
-				playfield_border.setPosition(sf::Vector2f(0.f, 0.f));
-				playfield_border.setFillColor(sf::Color(18, 18, 28));
-				playfield_border.setOutlineThickness(2.f);
-				playfield_border.setOutlineColor(sf::Color(80, 80, 130));
-
-				float side_x = static_cast<float>(CELL_SIZE * (COLUMNS + 0.05f));
-				float side_y = 4.f;
-				float side_w = static_cast<float>(CELL_SIZE * (COLUMNS - 0.25f));
-				float side_h = static_cast<float>(CELL_SIZE * ROWS - 8.f);
-
-				sf::RectangleShape side_panel(sf::Vector2f(side_w, side_h));
-				side_panel.setPosition(sf::Vector2f(side_x, side_y));
-				side_panel.setFillColor(sf::Color(12, 12, 20, 230));
-				side_panel.setOutlineThickness(2.f);
-				side_panel.setOutlineColor(sf::Color(70, 70, 110));
-
-				float next_block_h = static_cast<float>(4 * CELL_SIZE + 14);
-				sf::RectangleShape next_panel(sf::Vector2f(side_w - 8.f, next_block_h));
-				next_panel.setPosition(sf::Vector2f(side_x + 4.f, side_y + 4.f));
-				next_panel.setFillColor(sf::Color(8, 8, 14, 230));
-				next_panel.setOutlineThickness(1.5f);
-				next_panel.setOutlineColor(sf::Color(90, 90, 140));
-
-				sf::RectangleShape stats_panel(sf::Vector2f(side_w - 8.f, side_h - next_block_h - 10.f));
-				stats_panel.setPosition(sf::Vector2f(side_x + 4.f, side_y + next_block_h + 6.f));
-				stats_panel.setFillColor(sf::Color(10, 10, 16, 230));
-				stats_panel.setOutlineThickness(1.5f);
-				stats_panel.setOutlineColor(sf::Color(70, 70, 110));
-
-				sf::RectangleShape preview_border(sf::Vector2f(static_cast<float>(5 * CELL_SIZE), static_cast<float>(4 * CELL_SIZE)));
-				preview_border.setFillColor(sf::Color(6, 6, 12));
-				preview_border.setOutlineThickness(1.f);
-				preview_border.setOutlineColor(sf::Color(90, 90, 140));
-				preview_border.setPosition(sf::Vector2f(next_panel.getPosition().x + 10.f, next_panel.getPosition().y + 16.f));
-
-				sf::RectangleShape modal_shadow(sf::Vector2f(static_cast<float>(modal_w + 12), static_cast<float>(modal_h + 12)));
-				modal_shadow.setPosition(sf::Vector2f(static_cast<float>(modal_x - 6), static_cast<float>(modal_y - 6)));
-				modal_shadow.setFillColor(sf::Color(0, 0, 0, 170));
-
-				sf::RectangleShape modal_back(sf::Vector2f(static_cast<float>(modal_w), static_cast<float>(modal_h)));
-				modal_back.setPosition(sf::Vector2f(static_cast<float>(modal_x), static_cast<float>(modal_y)));
-				modal_back.setFillColor(sf::Color(16, 18, 30, 235));
-				modal_back.setOutlineThickness(2.5f);
-				modal_back.setOutlineColor(sf::Color(90, 200, 255));
-
-				auto draw_playfield = [&](bool draw_active_piece, bool show_background, bool draw_ui) {
-					if (show_background && has_background)
+				InputFrame input = {};
+
+				if (playback_active)
+				{
+					if (playback_frame < playback.inputs.size())
 					{
-						window.draw(background_sprite);
+						input = get_replay_frame(playback, playback_frame++, playback_event);
 					}
 					else
 					{
-						sf::RectangleShape backdrop(sf::Vector2f(view_rect.size.x, view_rect.size.y));
-						backdrop.setFillColor(sf::Color(8, 10, 18));
-						window.draw(backdrop);
+						//The recording stopped before the game ended.
+						game.game_over = 1;
 					}
+				}
+				else if (autoplay)
+				{
+					input = bot.get_input(game);
+				}
+				else
+				{
+					input = queued_input;
+				}
 
-					if (!draw_ui)
-					{
-						return;
-					}
+				if (recording_active)
+				{
+					record_replay_frame(input, recording);
+				}
 
-					// vignette overlay for depth
-					window.draw(playfield_border);
-					if (has_frame)
-					{
-						frame_sprite.setPosition(sf::Vector2f(0.f, 0.f));
-						window.draw(frame_sprite);
-					}
-					window.draw(side_panel);
-					window.draw(next_panel);
-					window.draw(preview_border);
-					window.draw(stats_panel);
-					//Draw the matrix
-					for (unsigned char a = 0; a < COLUMNS; a++)
-					{
-						for (unsigned char b = 0; b < ROWS; b++)
-						{
-							if (0 == clear_lines[b])
-							{
-								cell.setPosition(sf::Vector2f(static_cast<float>(CELL_SIZE * a), static_cast<float>(CELL_SIZE * b)));
-								cell.setFillColor(cell_colors[matrix[a][b]]);
-								window.draw(cell);
-							}
-						}
-					}
+				bool changed = game.step(input);
 
-					//Ghost + active tetromino
-					if (draw_active_piece && 0 == game_over)
-					{
-						cell.setFillColor(cell_colors[8]);
-						for (Position& mino : tetromino.get_ghost_minos(matrix))
-						{
-							cell.setPosition(sf::Vector2f(static_cast<float>(CELL_SIZE * mino.x), static_cast<float>(CELL_SIZE * mino.y)));
-							window.draw(cell);
-						}
+				if (changed)
+				{
+					redraw = true;
+				}
 
-						cell.setFillColor(cell_colors[1 + tetromino.get_shape()]);
-						for (Position& mino : tetromino.get_minos())
-						{
-							cell.setPosition(sf::Vector2f(static_cast<float>(CELL_SIZE * mino.x), static_cast<float>(CELL_SIZE * mino.y)));
-							window.draw(cell);
-						}
-					}
+				//A press that didn't move anything, like pushing against a wall, isn't timed.
+				if (input_pending && 0 != input.event_count)
+				{
+					input_pending = false;
 
-					//Clear effect overlay
-					for (unsigned char a = 0; a < COLUMNS; a++)
+					if (changed)
 					{
-						for (unsigned char b = 0; b < ROWS; b++)
-						{
-							if (1 == clear_lines[b])
-							{
-								cell.setFillColor(cell_colors[0]);
-								cell.setPosition(sf::Vector2f(static_cast<float>(CELL_SIZE * a), static_cast<float>(CELL_SIZE * b)));
-								cell.setSize(sf::Vector2f(static_cast<float>(CELL_SIZE - 1), static_cast<float>(CELL_SIZE - 1)));
-								window.draw(cell);
-
-								cell.setFillColor(sf::Color(255, 255, 255));
-								cell.setPosition(sf::Vector2f(static_cast<float>(std::floor(CELL_SIZE * (0.5f + a) - 0.5f * clear_cell_size)), static_cast<float>(std::floor(CELL_SIZE * (0.5f + b) - 0.5f * clear_cell_size))));
-								cell.setSize(sf::Vector2f(static_cast<float>(clear_cell_size), static_cast<float>(clear_cell_size)));
-								window.draw(cell);
-							}
-						}
+						input_sequence++;
 					}
+				}
 
-					if (draw_active_piece)
-					{
-						cell.setFillColor(cell_colors[1 + next_shape]);
-						cell.setSize(sf::Vector2f(static_cast<float>(CELL_SIZE - 1), static_cast<float>(CELL_SIZE - 1)));
-						if (has_nextbox)
-						{
-							nextbox_sprite.setPosition(preview_border.getPosition());
-							window.draw(nextbox_sprite);
-						}
-						else
-						{
-							window.draw(preview_border);
-						}
-
-						float base_x = preview_border.getPosition().x;
-						float base_y = preview_border.getPosition().y;
-						auto preview_minos = get_tetromino(next_shape, 1, 1);
-						char min_x = preview_minos[0].x, max_x = preview_minos[0].x;
-						char min_y = preview_minos[0].y, max_y = preview_minos[0].y;
-						for (const auto& m : preview_minos)
-						{
-							min_x = std::min(min_x, m.x);
-							max_x = std::max(max_x, m.x);
-							min_y = std::min(min_y, m.y);
-							max_y = std::max(max_y, m.y);
-						}
-						float shape_w = static_cast<float>((max_x - min_x + 1) * CELL_SIZE);
-						float shape_h = static_cast<float>((max_y - min_y + 1) * CELL_SIZE);
-						float offset_x = base_x + 0.5f * (preview_border.getSize().x - shape_w) - static_cast<float>(min_x * CELL_SIZE);
-						float offset_y = base_y + 0.5f * (preview_border.getSize().y - shape_h) - static_cast<float>(min_y * CELL_SIZE);
-						for (const auto& mino : preview_minos)
-						{
-							float next_tetromino_x = offset_x + CELL_SIZE * mino.x;
-							float next_tetromino_y = offset_y + CELL_SIZE * mino.y;
-							cell.setPosition(sf::Vector2f(next_tetromino_x, next_tetromino_y));
-							window.draw(cell);
-						}
+				if (game.game_over)
+				{
+					screen = Screen::GameOver;
+					finish_recording();
+					try_post_score();
+				}
+			}
+			else
+			{
+				input_pending = false;
+			}
 
-						draw_text(static_cast<unsigned short>(next_panel.getPosition().x + 6.f), static_cast<unsigned short>(next_panel.getPosition().y + 4.f), "Next", window);
-					}
-				};
+			//The overlay changes every frame.
+			if (show_profiler)
+			{
+				redraw = true;
+			}
 
-				switch (state)
-				{
-					case GameState::Menu:
-					{
-						draw_playfield(false, true, false);
-						window.draw(modal_shadow);
-						window.draw(modal_back);
-						unsigned short menu_y = static_cast<unsigned short>(modal_y + 12);
-						draw_text(static_cast<unsigned short>(modal_x + 12), menu_y, "TETRIS\n\n1) Beginner\n2) Advanced\n3) High Scores\n4) Help\n5) Quit", window);
-						break;
-					}
-					case GameState::HighScores:
-					{
-						draw_playfield(false, false, false);
-						window.draw(modal_shadow);
-						window.draw(modal_back);
-						std::string scores_text = "High Scores\n";
-						for (std::size_t i = 0; i < high_scores.size(); ++i)
-						{
-							scores_text += std::to_string(i + 1) + ". " + std::to_string(high_scores[i]) + "\n";
-						}
-						scores_text += "\nAny key to return";
-						unsigned short hs_y = static_cast<unsigned short>(modal_y + 12);
-						draw_text(static_cast<unsigned short>(modal_x + 12), hs_y, scores_text, window);
-						break;
-					}
-					case GameState::Help:
-					{
-						draw_playfield(false, false, false);
-						window.draw(modal_shadow);
-						window.draw(modal_back);
-						std::string help_text = "Help\nLeft/Right: Move\nZ/C: Rotate\nDown: Soft drop\nSpace: Hard drop\nP: Pause\nEnter: Menu (post game)\n\nAny key to return";
-						unsigned short help_y = static_cast<unsigned short>(modal_y + 12);
-						draw_text(static_cast<unsigned short>(modal_x + 12), help_y, help_text, window);
-						break;
-					}
-					case GameState::Paused:
-					case GameState::Playing:
-					case GameState::GameOver:
-					{
-						unsigned short ui_x = static_cast<unsigned short>(stats_panel.getPosition().x + 4.f);
-						unsigned short ui_y = static_cast<unsigned short>(stats_panel.getPosition().y + 6.f);
-						draw_playfield(state != GameState::GameOver, false, true);
+			late_updates += catching_up;
+			updates++;
+			update_time += std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - update_start);
 
-						if (has_scorebar)
-						{
-							scorebar_sprite.setPosition(sf::Vector2f(stats_panel.getPosition().x + 4.f, stats_panel.getPosition().y + 4.f));
-							window.draw(scorebar_sprite);
-						}
+			catching_up = true;
 
-						std::string stats = "Score: " + std::to_string(score) +
-							"\nLines: " + std::to_string(lines_cleared) +
-							"\nLevel: " + std::to_string(level) +
-							"\nSpeed: " + std::to_string(START_FALL_SPEED / current_fall_speed) + "x" +
-							"\nLocked: " + std::to_string(locked_rows) +
-							"\nTime: " + time_text +
-							"\nMode: " + std::string(advanced_mode ? "Advanced" : "Beginner") +
-							"\nBest: " + std::to_string(high_scores.front());
-						draw_text(ui_x, ui_y, stats, window);
-
-						if (state == GameState::Paused)
-						{
-							window.draw(modal_back);
-							draw_text(static_cast<unsigned short>(modal_x + 8), static_cast<unsigned short>(modal_y + 8), "Paused\n1) Beginner\n2) Advanced\n3) High Scores\n4) Help\n5) Continue\nEnter for menu", window);
-						}
-						else if (state == GameState::GameOver)
-						{
-							window.draw(modal_back);
-							draw_text(static_cast<unsigned short>(modal_x + 8), static_cast<unsigned short>(modal_y + 8), "Game Over\nScore:" + std::to_string(score) + "\nEnter for menu", window);
-						}
-						break;
-					}
-				}
+			//Nothing is drawn while nothing changed.
+			if (redraw)
+			{
+				redraw = false;
 
-				window.display();
+				publish_frame();
 			}
 		}
+
+		//Sleeping until the next update instead of spinning, but waking up every millisecond to read the events close to when they happened.
+		std::this_thread::sleep_until(std::min(update_start_time + std::chrono::microseconds(FRAME_DURATION), std::chrono::steady_clock::now() + std::chrono::milliseconds(1)));
+	}
+
+	//Waking the render thread up so that it sees the game is closing.
+	{
+		std::lock_guard<std::mutex> lock(frame_mutex);
+		running = false;
+	}
+	frame_condition.notify_one();
+
+	render_thread.join();
+
+	window.close();
+
+	finish_recording();
+
+	if (!profile_csv_path.empty())
+	{
+		profiler.save_csv(profile_csv_path);
 	}
-}
\ No newline at end of file
+}
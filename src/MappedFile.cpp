@@ -0,0 +1,137 @@
+#include <cstddef>
+#include <string>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "MappedFile.hpp"
+
+MappedFile::MappedFile() :
+	data(nullptr),
+	size(0),
+	file_handle(nullptr),
+	mapping_handle(nullptr)
+{
+}
+
+MappedFile::~MappedFile()
+{
+	close();
+}
+
+bool MappedFile::open(const std::string& i_path)
+{
+	close();
+
+#ifdef _WIN32
+	HANDLE file = CreateFileA(i_path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+
+	if (INVALID_HANDLE_VALUE == file)
+	{
+		return 0;
+	}
+
+	LARGE_INTEGER file_size;
+
+	if (0 == GetFileSizeEx(file, &file_size) || 0 == file_size.QuadPart)
+	{
+		CloseHandle(file);
+
+		return 0;
+	}
+
+	HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+
+	if (nullptr == mapping)
+	{
+		CloseHandle(file);
+
+		return 0;
+	}
+
+	const void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+
+	if (nullptr == view)
+	{
+		CloseHandle(mapping);
+		CloseHandle(file);
+
+		return 0;
+	}
+
+	data = static_cast<const unsigned char*>(view);
+	size = static_cast<std::size_t>(file_size.QuadPart);
+	file_handle = file;
+	mapping_handle = mapping;
+#else
+	int descriptor = ::open(i_path.c_str(), O_RDONLY);
+
+	if (0 > descriptor)
+	{
+		return 0;
+	}
+
+	struct stat file_status;
+
+	if (0 != fstat(descriptor, &file_status) || 0 == file_status.st_size)
+	{
+		::close(descriptor);
+
+		return 0;
+	}
+
+	void* view = mmap(nullptr, static_cast<std::size_t>(file_status.st_size), PROT_READ, MAP_PRIVATE, descriptor, 0);
+
+	//The mapping stays valid after the file is closed.
+	::close(descriptor);
+
+	if (MAP_FAILED == view)
+	{
+		return 0;
+	}
+
+	data = static_cast<const unsigned char*>(view);
+	size = static_cast<std::size_t>(file_status.st_size);
+#endif
+
+	return 1;
+}
+
+const unsigned char* MappedFile::get_data() const
+{
+	return data;
+}
+
+std::size_t MappedFile::get_size() const
+{
+	return size;
+}
+
+void MappedFile::close()
+{
+	if (nullptr == data)
+	{
+		return;
+	}
+
+#ifdef _WIN32
+	UnmapViewOfFile(data);
+	CloseHandle(static_cast<HANDLE>(mapping_handle));
+	CloseHandle(static_cast<HANDLE>(file_handle));
+#else
+	munmap(const_cast<unsigned char*>(data), size);
+#endif
+
+	data = nullptr;
+	size = 0;
+	file_handle = nullptr;
+	mapping_handle = nullptr;
+}
@@ -0,0 +1,320 @@
+#include <algorithm>
+#include <array>
+#include <bitset>
+#include <vector>
+
+#include "Global.hpp"
+#include "Board.hpp"
+#include "GetTetromino.hpp"
+#include "GetWallKickData.hpp"
+#include "RotationTable.hpp"
+#include "Tetromino.hpp"
+#include "MoveGenerator.hpp"
+
+//The cells of the minos as one number: the corner of the 4x4 box around them, and which cells of the box they fill.
+static unsigned long long get_cells(const std::array<Position, 4>& i_minos)
+{
+	signed char x = i_minos[0].x;
+	signed char y = i_minos[0].y;
+
+	unsigned cells = 0;
+
+	for (const Position& mino : i_minos)
+	{
+		x = std::min(x, mino.x);
+		y = std::min(y, mino.y);
+	}
+
+	for (const Position& mino : i_minos)
+	{
+		cells |= 1u << (4 * (mino.y - y) + mino.x - x);
+	}
+
+	return cells | static_cast<unsigned long long>(static_cast<unsigned char>(x)) << 16 | static_cast<unsigned long long>(static_cast<unsigned char>(y)) << 24;
+}
+
+static void move_minos(std::array<Position, 4>& i_minos, signed char i_offset_x, signed char i_offset_y)
+{
+	for (Position& mino : i_minos)
+	{
+		mino.x += i_offset_x;
+		mino.y += i_offset_y;
+	}
+}
+
+MoveGenerator::MoveGenerator() :
+	shape(0),
+	surfaces(),
+	walled_rows()
+{
+}
+
+bool MoveGenerator::collides(const std::array<Position, 4>& i_minos, signed char i_offset_x, signed char i_offset_y) const
+{
+	unsigned long long cells = 0;
+
+	//The states we move from are never in a wall, so the minos stay within a few cells of the matrix and the margins.
+	for (const Position& mino : i_minos)
+	{
+		cells |= walled_rows[2 * MOVE_MARGIN + mino.y + i_offset_y] >> (MOVE_MARGIN + mino.x + i_offset_x);
+	}
+
+	return 1 & cells;
+}
+
+signed char MoveGenerator::get_drop_distance(const std::array<Position, 4>& i_minos) const
+{
+	signed char drop_distance = MAX_ROWS;
+
+	for (const Position& mino : i_minos)
+	{
+		signed char mino_distance = 0;
+
+		if (surfaces[mino.x] > mino.y)
+		{
+			//Everything above the surface is empty, so the mino falls right onto it.
+			mino_distance = surfaces[mino.x] - mino.y - 1;
+		}
+		else
+		{
+			//The mino is tucked under an overhang, so we have to look for the first occupied cell below it.
+			while (0 == (1 & walled_rows[2 * MOVE_MARGIN + 1 + mino.y + mino_distance] >> (MOVE_MARGIN + mino.x)))
+			{
+				mino_distance++;
+			}
+		}
+
+		drop_distance = std::min(drop_distance, mino_distance);
+	}
+
+	return drop_distance;
+}
+
+bool MoveGenerator::make_move(Move i_move, std::array<Position, 4>& i_minos, unsigned char& i_rotation) const
+{
+	signed char offset_x = 0;
+
+	switch (i_move)
+	{
+		case Move::Left:
+		case Move::DasLeft:
+		{
+			offset_x = -1;
+
+			break;
+		}
+		case Move::Right:
+		case Move::DasRight:
+		{
+			offset_x = 1;
+
+			break;
+		}
+		case Move::RotateCw:
+		{
+			return rotate(1, i_minos, i_rotation);
+		}
+		case Move::RotateCcw:
+		{
+			return rotate(0, i_minos, i_rotation);
+		}
+		default:
+		{
+			//The search doesn't try this on minos that landed, so they always fall.
+			move_minos(i_minos, 0, get_drop_distance(i_minos));
+
+			return 1;
+		}
+	}
+
+	if (1 == collides(i_minos, offset_x, 0))
+	{
+		return 0;
+	}
+
+	do
+	{
+		move_minos(i_minos, offset_x, 0);
+	}
+	while ((Move::DasLeft == i_move || Move::DasRight == i_move) && 0 == collides(i_minos, offset_x, 0));
+
+	return 1;
+}
+
+bool MoveGenerator::rotate(bool i_clockwise, std::array<Position, 4>& i_minos, unsigned char& i_rotation) const
+{
+	if (3 == shape)
+	{
+		return 0;
+	}
+
+	const Rotation& turn = ROTATION_TABLE[shape][i_rotation][i_clockwise];
+
+	std::array<Position, 4> minos = i_minos;
+
+	for (unsigned char a = 0; a < minos.size(); a++)
+	{
+		minos[a].x += turn.minos[a].x;
+		minos[a].y += turn.minos[a].y;
+	}
+
+	for (const Position& wall_kick : turn.wall_kicks)
+	{
+		if (0 == collides(minos, wall_kick.x, wall_kick.y))
+		{
+			move_minos(minos, wall_kick.x, wall_kick.y);
+
+			i_minos = minos;
+			i_rotation = (1 == i_clockwise ? 1 + i_rotation : 3 + i_rotation) % 4;
+
+			return 1;
+		}
+	}
+
+	return 0;
+}
+
+bool MoveGenerator::get_path(const std::array<Position, 4>& i_minos, std::vector<Move>& i_path) const
+{
+	unsigned long long cells = get_cells(i_minos);
+
+	i_path.clear();
+
+	for (std::size_t a = 0; a < landings.size(); a++)
+	{
+		if (cells == landing_cells[a])
+		{
+			//The first state is where the search started, so it's where every path ends going backwards.
+			for (unsigned short b = landings[a]; 0 != b; b = states[b].parent)
+			{
+				i_path.push_back(states[b].move);
+			}
+
+			std::reverse(i_path.begin(), i_path.end());
+
+			return 1;
+		}
+	}
+
+	return 0;
+}
+
+const std::array<Position, 4>& MoveGenerator::get_landing_minos(unsigned short i_index) const
+{
+	return states[landings[i_index]].minos;
+}
+
+unsigned char MoveGenerator::get_landing_rotation(unsigned short i_index) const
+{
+	return states[landings[i_index]].rotation;
+}
+
+unsigned short MoveGenerator::get_landing_count() const
+{
+	return static_cast<unsigned short>(landings.size());
+}
+
+void MoveGenerator::search(const Tetromino& i_tetromino, const Board& i_matrix)
+{
+	//Everything but the columns of the matrix, shifted into place.
+	unsigned long long walls = ~(static_cast<unsigned long long>(i_matrix.get_full_row()) << MOVE_MARGIN);
+
+	shape = i_tetromino.get_shape();
+
+	for (unsigned char a = 0; a < i_matrix.get_width(); a++)
+	{
+		surfaces[a] = static_cast<signed char>(i_matrix.get_height() - i_matrix.get_column_height(a));
+	}
+
+	//Cells above the playfield are always free.
+	std::fill(walled_rows.begin(), walled_rows.begin() + 2 * MOVE_MARGIN, walls);
+	std::fill(walled_rows.begin() + 2 * MOVE_MARGIN + i_matrix.get_height(), walled_rows.end(), ~0ull);
+
+	for (unsigned char a = 0; a < i_matrix.get_height(); a++)
+	{
+		walled_rows[2 * MOVE_MARGIN + a] = walls | static_cast<unsigned long long>(i_matrix.get_row(a)) << MOVE_MARGIN;
+	}
+
+	visited.reset();
+
+	landing_cells.clear();
+	landings.clear();
+	states.clear();
+
+	visit(i_tetromino.get_minos(), i_tetromino.get_rotation(), 0, 0, Move::SoftDrop);
+
+	//The states are added while we go through them, which is the queue of the search.
+	for (unsigned short a = 0; a < states.size(); a++)
+	{
+		//A tetromino in the air that was dropped before can only keep falling.
+		unsigned char first_move = 0 == states[a].landed && 1 == states[a].dropped ? static_cast<unsigned char>(Move::SoftDrop) : 0;
+		unsigned char move_count = 1 == states[a].landed ? static_cast<unsigned char>(Move::SoftDrop) : MOVE_COUNT;
+
+		Move previous_move = states[a].move;
+
+		//After a shift, the delayed auto shift stops at the same wall as from where the shift started, which was a shorter way there.
+		bool shifted = Move::Left == previous_move || Move::Right == previous_move || Move::DasLeft == previous_move || Move::DasRight == previous_move;
+
+		for (unsigned char b = first_move; b < move_count; b++)
+		{
+			Move move = static_cast<Move>(b);
+
+			//Shifting straight back only goes where we came from.
+			if ((Move::Left == move && Move::Right == previous_move) || (Move::Right == move && Move::Left == previous_move))
+			{
+				continue;
+			}
+
+			if (1 == shifted && (Move::DasLeft == move || Move::DasRight == move))
+			{
+				continue;
+			}
+
+			std::array<Position, 4> minos = states[a].minos;
+
+			unsigned char rotation = states[a].rotation;
+
+			if (1 == make_move(move, minos, rotation))
+			{
+				visit(minos, rotation, a, 1 == states[a].dropped || Move::SoftDrop == move, move);
+			}
+		}
+	}
+}
+
+void MoveGenerator::visit(const std::array<Position, 4>& i_minos, unsigned char i_rotation, unsigned short i_parent, bool i_dropped, Move i_move)
+{
+	int x = MOVE_MARGIN + i_minos[0].x;
+	int y = MOVE_MARGIN + i_minos[0].y;
+
+	//Only wall kicks that keep lifting the tetromino above the matrix could get this far, and nothing up there is worth reaching.
+	if (0 > x || MAX_COLUMNS + 2 * MOVE_MARGIN <= x || 0 > y || MAX_ROWS + 2 * MOVE_MARGIN <= y)
+	{
+		return;
+	}
+
+	unsigned index = (i_rotation * (MAX_ROWS + 2 * MOVE_MARGIN) + y) * (MAX_COLUMNS + 2 * MOVE_MARGIN) + x;
+
+	if (1 == visited[index])
+	{
+		return;
+	}
+
+	bool landed = collides(i_minos, 0, 1);
+
+	visited[index] = 1;
+
+	states.push_back({i_dropped, landed, i_move, i_rotation, i_parent, i_minos});
+
+	if (1 == landed)
+	{
+		unsigned long long cells = get_cells(i_minos);
+
+		//Some shapes look the same in different rotations, and the one we found first has the shorter path.
+		if (landing_cells.end() == std::find(landing_cells.begin(), landing_cells.end(), cells))
+		{
+			landing_cells.push_back(cells);
+			landings.push_back(static_cast<unsigned short>(states.size() - 1));
+		}
+	}
+}
@@ -0,0 +1,250 @@
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "Global.hpp"
+#include "Board.hpp"
+#include "Tetromino.hpp"
+#include "Randomizer.hpp"
+#include "PieceQueue.hpp"
+#include "GameState.hpp"
+#include "ThreadPool.hpp"
+#include "MoveGenerator.hpp"
+#include "TranspositionTable.hpp"
+#include "Bot.hpp"
+#include "Policy.hpp"
+#include "Simulation.hpp"
+#include "DurableFile.hpp"
+#include "Optimizer.hpp"
+
+//The first line of a checkpoint. The second one is the generation, then every candidate has a line with its fitness and its weights.
+const std::string CHECKPOINT_HEADER = "tetris-optimizer 1";
+
+//How much of the population is replaced by children every generation.
+constexpr float REPLACED_SHARE = 0.3f;
+//How much of the population takes part in choosing each parent.
+constexpr float TOURNAMENT_SHARE = 0.1f;
+
+//A number from -1 to 1.
+static float get_uniform(Xoshiro256& i_random_engine)
+{
+	return static_cast<float>(i_random_engine() >> 40) / (1 << 23) - 1;
+}
+
+static void normalize(BotWeights& i_weights)
+{
+	float length = 0;
+
+	for (float weight : i_weights)
+	{
+		length += weight * weight;
+	}
+
+	if (0 < length)
+	{
+		length = std::sqrt(length);
+
+		for (float& weight : i_weights)
+		{
+			weight /= length;
+		}
+	}
+}
+
+Optimizer::Optimizer(const OptimizerSettings& i_settings, ThreadPool& i_thread_pool) :
+	generation(0),
+	settings(i_settings),
+	thread_pool(i_thread_pool)
+{
+	Xoshiro256 random_engine(settings.seed);
+
+	settings.population_size = std::max(2u, settings.population_size);
+
+	population.resize(settings.population_size);
+
+	for (unsigned a = 0; a < settings.population_size; a++)
+	{
+		population[a].fitness = -1;
+
+		if (0 == a)
+		{
+			population[a].weights = DEFAULT_BOT_WEIGHTS;
+		}
+		else
+		{
+			for (float& weight : population[a].weights)
+			{
+				weight = get_uniform(random_engine);
+			}
+		}
+
+		normalize(population[a].weights);
+	}
+}
+
+bool Optimizer::load_checkpoint()
+{
+	std::ifstream file(settings.checkpoint_path);
+
+	std::string header;
+
+	unsigned checkpoint_generation = 0;
+
+	std::vector<Candidate> checkpoint_population(settings.population_size);
+
+	if (0 == file.is_open() || !std::getline(file, header) || CHECKPOINT_HEADER != header || !(file >> checkpoint_generation))
+	{
+		return 0;
+	}
+
+	for (Candidate& candidate : checkpoint_population)
+	{
+		std::string weights;
+
+		if (!(file >> candidate.fitness >> weights) || 0 == parse_weights(weights, candidate.weights))
+		{
+			return 0;
+		}
+	}
+
+	//A checkpoint of a bigger population.
+	if (file >> header)
+	{
+		return 0;
+	}
+
+	generation = checkpoint_generation;
+	population = checkpoint_population;
+
+	return 1;
+}
+
+bool Optimizer::save_checkpoint() const
+{
+	std::ostringstream text;
+
+	text.precision(17);
+
+	text << CHECKPOINT_HEADER << '\n' << generation << '\n';
+
+	for (const Candidate& candidate : population)
+	{
+		text << candidate.fitness << ' ' << format_weights(candidate.weights) << '\n';
+	}
+
+	std::string checkpoint = text.str();
+
+	return replace_file_contents(settings.checkpoint_path, std::vector<unsigned char>(checkpoint.begin(), checkpoint.end()));
+}
+
+const std::vector<Candidate>& Optimizer::get_population() const
+{
+	return population;
+}
+
+unsigned Optimizer::get_generation() const
+{
+	return generation;
+}
+
+void Optimizer::run_generation()
+{
+	unsigned child_count = std::max(1u, static_cast<unsigned>(REPLACED_SHARE * settings.population_size));
+	unsigned tournament_size = std::max(2u, static_cast<unsigned>(TOURNAMENT_SHARE * settings.population_size));
+
+	//Common seeds make the candidates of a generation comparable with much fewer games.
+	unsigned first_seed = settings.seed + generation * settings.game_count;
+
+	SimulationSettings simulation = settings.simulation;
+
+	Xoshiro256 random_engine(static_cast<std::uint64_t>(settings.seed) << 32 | (1 + generation));
+
+	std::vector<Candidate> children(child_count);
+
+	//The candidates are played one after the other, with the games of each one spread over the pool.
+	for (Candidate& candidate : population)
+	{
+		double total_score = 0;
+
+		simulation.weights = candidate.weights;
+
+		for (const GameResult& result : simulate_games(simulation, first_seed, settings.game_count, thread_pool))
+		{
+			total_score += result.score;
+		}
+
+		candidate.fitness = total_score / std::max(1u, settings.game_count);
+	}
+
+	//Stable, so that equal candidates keep their order and a run always goes the same way.
+	std::stable_sort(population.begin(), population.end(), [](const Candidate& i_a, const Candidate& i_b)
+	{
+		return i_a.fitness > i_b.fitness;
+	});
+
+	//The population is sorted, so the lowest index in a tournament is its winner.
+	auto choose_parent = [&](unsigned i_excluded)
+	{
+		unsigned parent = settings.population_size;
+
+		for (unsigned a = 0; a < tournament_size; a++)
+		{
+			unsigned index = random_engine.get_below(settings.population_size);
+
+			if (i_excluded != index)
+			{
+				parent = std::min(parent, index);
+			}
+		}
+
+		return settings.population_size == parent ? (0 == i_excluded ? 1 : 0) : parent;
+	};
+
+	for (Candidate& child : children)
+	{
+		unsigned first_parent = choose_parent(settings.population_size);
+		unsigned second_parent = choose_parent(first_parent);
+
+		double first_fitness = population[first_parent].fitness;
+		double second_fitness = population[second_parent].fitness;
+
+		//The better parent pulls the child closer to itself.
+		if (0 >= first_fitness + second_fitness)
+		{
+			first_fitness = 1;
+			second_fitness = 1;
+		}
+
+		for (unsigned char a = 0; a < BOT_FEATURE_COUNT; a++)
+		{
+			child.weights[a] = static_cast<float>(first_fitness * population[first_parent].weights[a] + second_fitness * population[second_parent].weights[a]);
+		}
+
+		if (1 + get_uniform(random_engine) < 2 * settings.mutation_rate)
+		{
+			child.weights[random_engine.get_below(BOT_FEATURE_COUNT)] += settings.mutation_size * get_uniform(random_engine);
+		}
+
+		normalize(child.weights);
+
+		child.fitness = -1;
+	}
+
+	population.resize(settings.population_size - child_count);
+	population.insert(population.end(), children.begin(), children.end());
+
+	generation++;
+
+	if (0 == settings.checkpoint_path.empty() && 0 == save_checkpoint())
+	{
+		std::cerr << "Can't save the checkpoint to " << settings.checkpoint_path << std::endl;
+	}
+}
@@ -0,0 +1,47 @@
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <memory>
+
+#include "Randomizer.hpp"
+#include "PieceQueue.hpp"
+
+PieceQueue::PieceQueue() :
+	count(0),
+	front(0)
+{
+	shapes.fill(0);
+}
+
+unsigned char PieceQueue::get(unsigned char i_index) const
+{
+	return shapes[(front + i_index) % count];
+}
+
+unsigned char PieceQueue::get_count() const
+{
+	return count;
+}
+
+unsigned char PieceQueue::pop(Randomizer& i_randomizer)
+{
+	unsigned char shape = shapes[front];
+
+	//The slot we just read becomes the back of the queue.
+	shapes[front] = i_randomizer.next();
+
+	front = (1 + front) % count;
+
+	return shape;
+}
+
+void PieceQueue::reset(unsigned char i_count, Randomizer& i_randomizer)
+{
+	count = std::clamp<unsigned char>(i_count, 1, MAX_PREVIEW);
+	front = 0;
+
+	for (unsigned char a = 0; a < count; a++)
+	{
+		shapes[a] = i_randomizer.next();
+	}
+}
@@ -0,0 +1,228 @@
+#include <SFML/Graphics.hpp>
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <memory>
+#include <vector>
+
+#include "Global.hpp"
+#include "Board.hpp"
+#include "GetTetromino.hpp"
+#include "Tetromino.hpp"
+#include "Randomizer.hpp"
+#include "PieceQueue.hpp"
+#include "GameState.hpp"
+#include "GameSnapshot.hpp"
+#include "SpriteBatch.hpp"
+#include "TextureAtlas.hpp"
+#include "PlayfieldMesh.hpp"
+
+//The quads are laid out as: the cells of the matrix, then one clear effect square per cell, then the preview box and the 4 minos of every upcoming shape.
+//So the clear effect quads start at width * height and the preview quads at 2 * width * height.
+constexpr unsigned char NO_CELL = 255;
+
+PlayfieldMesh::PlayfieldMesh(const TextureAtlas& i_atlas, const std::vector<sf::Color>& i_colors, const std::vector<sf::IntRect>& i_cell_rects) :
+	has_preview_box(i_atlas.has_region("nextbox")),
+	preview_visible(0),
+	clear_cell_size(0),
+	height(0),
+	preview_count(0),
+	width(0),
+	colors(i_colors),
+	cell_rects(i_cell_rects),
+	preview_box_rect(i_atlas.get_region("nextbox")),
+	white_rect(i_atlas.get_region("white"))
+{
+	batch.set_texture(i_atlas.get_texture());
+
+	resize(COLUMNS, ROWS);
+}
+
+void PlayfieldMesh::draw(sf::RenderTarget& i_target, sf::RenderStates i_states) const
+{
+	i_target.draw(batch, i_states);
+}
+
+void PlayfieldMesh::resize(unsigned char i_width, unsigned char i_height)
+{
+	height = i_height;
+	width = i_width;
+
+	//Forcing every cell and the preview to be written on the next update.
+	preview_shapes.fill(NO_CELL);
+
+	cells.assign(width * height, NO_CELL);
+
+	effect_rows.assign(height, 0);
+
+	batch.resize(1 + 4 * MAX_PREVIEW + 2 * width * height);
+
+	for (unsigned short a = 0; a < cells.size(); a++)
+	{
+		set_cell(a, 0);
+	}
+}
+
+void PlayfieldMesh::set_cell(unsigned short i_index, unsigned char i_cell)
+{
+	//Skins only change which region a cell samples, so drawing them costs the same as flat colors.
+	sf::FloatRect position(sf::Vector2f(CELL_SIZE * (i_index % width), CELL_SIZE * (i_index / width)), sf::Vector2f(CELL_SIZE - 1, CELL_SIZE - 1));
+
+	batch.set_quad(i_index, position, cell_rects[i_cell], colors[i_cell]);
+}
+
+void PlayfieldMesh::set_preview_shape(unsigned char i_index, unsigned char i_shape, const sf::Vector2f& i_center, float i_cell_size)
+{
+	std::array<Position, 4> minos = get_tetromino(i_shape, 1, 1);
+
+	signed char max_x = minos[0].x;
+	signed char max_y = minos[0].y;
+	signed char min_x = minos[0].x;
+	signed char min_y = minos[0].y;
+
+	for (const Position& mino : minos)
+	{
+		max_x = std::max(max_x, mino.x);
+		max_y = std::max(max_y, mino.y);
+		min_x = std::min(min_x, mino.x);
+		min_y = std::min(min_y, mino.y);
+	}
+
+	float offset_x = std::round(i_center.x - 0.5f * i_cell_size * (1 + max_x - min_x)) - i_cell_size * min_x;
+	float offset_y = std::round(i_center.y - 0.5f * i_cell_size * (1 + max_y - min_y)) - i_cell_size * min_y;
+
+	//The same 1 pixel gap as between the cells of the matrix, unless the cells are too small to have one.
+	float mino_size = std::max(1.f, i_cell_size - 1);
+
+	for (unsigned char a = 0; a < minos.size(); a++)
+	{
+		sf::FloatRect position(sf::Vector2f(offset_x + i_cell_size * minos[a].x, offset_y + i_cell_size * minos[a].y), sf::Vector2f(mino_size, mino_size));
+
+		batch.set_quad(1 + 2 * width * height + 4 * i_index + a, position, cell_rects[1 + i_shape], colors[1 + i_shape]);
+	}
+}
+
+void PlayfieldMesh::update(GameSnapshot& i_snapshot, bool i_draw_active_piece, const sf::Vector2f& i_preview_position, const sf::Vector2f& i_preview_size, const sf::FloatRect& i_queue_area)
+{
+	unsigned char next_clear_cell_size = static_cast<unsigned char>(2 * std::round(0.5f * CELL_SIZE * (i_snapshot.clear_effect_timer / static_cast<float>(CLEAR_EFFECT_DURATION))));
+
+	if (width != i_snapshot.matrix.get_width() || height != i_snapshot.matrix.get_height())
+	{
+		resize(i_snapshot.matrix.get_width(), i_snapshot.matrix.get_height());
+	}
+
+	next_cells.resize(cells.size());
+
+	for (unsigned char a = 0; a < height; a++)
+	{
+		for (unsigned char b = 0; b < width; b++)
+		{
+			//The rows that are being cleared are drawn empty, with the clear effect on top.
+			next_cells[b + width * a] = 1 == i_snapshot.clear_lines[a] ? 0 : i_snapshot.matrix.get_cell(b, a);
+		}
+	}
+
+	if (1 == i_draw_active_piece && 0 == i_snapshot.game_over)
+	{
+		for (const Position& mino : i_snapshot.tetromino.get_ghost_minos(i_snapshot.matrix))
+		{
+			if (0 <= mino.y && 0 == i_snapshot.clear_lines[mino.y])
+			{
+				next_cells[mino.x + width * mino.y] = 8;
+			}
+		}
+
+		for (const Position& mino : i_snapshot.tetromino.get_minos())
+		{
+			if (0 <= mino.y && 0 == i_snapshot.clear_lines[mino.y])
+			{
+				next_cells[mino.x + width * mino.y] = 1 + i_snapshot.tetromino.get_shape();
+			}
+		}
+	}
+
+	for (unsigned short a = 0; a < cells.size(); a++)
+	{
+		if (cells[a] != next_cells[a])
+		{
+			cells[a] = next_cells[a];
+
+			set_cell(a, cells[a]);
+		}
+	}
+
+	for (unsigned char a = 0; a < height; a++)
+	{
+		bool effect_row = i_snapshot.clear_lines[a];
+
+		if (effect_row == effect_rows[a] && (0 == effect_row || next_clear_cell_size == clear_cell_size))
+		{
+			continue;
+		}
+
+		effect_rows[a] = effect_row;
+
+		for (unsigned char b = 0; b < width; b++)
+		{
+			if (1 == effect_row)
+			{
+				sf::FloatRect position(sf::Vector2f(std::floor(CELL_SIZE * (0.5f + b) - 0.5f * next_clear_cell_size), std::floor(CELL_SIZE * (0.5f + a) - 0.5f * next_clear_cell_size)), sf::Vector2f(next_clear_cell_size, next_clear_cell_size));
+
+				batch.set_quad(width * height + b + width * a, position, white_rect, sf::Color::White);
+			}
+			else
+			{
+				batch.hide_quad(width * height + b + width * a);
+			}
+		}
+	}
+
+	clear_cell_size = next_clear_cell_size;
+
+	if (preview_visible != i_draw_active_piece || preview_count != i_snapshot.preview_count || preview_shapes != i_snapshot.next_shapes)
+	{
+		preview_visible = i_draw_active_piece;
+		preview_count = i_snapshot.preview_count;
+		preview_shapes = i_snapshot.next_shapes;
+
+		//Every shape after the next one gets an equal slot down the queue area, and the cells are as big as the slot and the width allow, up to half a cell.
+		float queue_cell_size = 0;
+
+		if (1 < preview_count)
+		{
+			queue_cell_size = std::floor(std::min({0.5f * CELL_SIZE, i_queue_area.size.y / (2.5f * (preview_count - 1)), 0.25f * i_queue_area.size.x}));
+		}
+
+		if (1 == preview_visible && 1 == has_preview_box)
+		{
+			batch.set_quad(2 * width * height, sf::FloatRect(i_preview_position, i_preview_size), preview_box_rect, sf::Color::White);
+		}
+		else
+		{
+			batch.hide_quad(2 * width * height);
+		}
+
+		for (unsigned char a = 0; a < MAX_PREVIEW; a++)
+		{
+			if (1 == preview_visible && 0 == a)
+			{
+				set_preview_shape(a, preview_shapes[a], i_preview_position + i_preview_size * 0.5f, CELL_SIZE);
+			}
+			//Without room for even 1 pixel cells, the queue isn't drawn at all.
+			else if (1 == preview_visible && a < preview_count && 1 <= queue_cell_size)
+			{
+				float slot_height = i_queue_area.size.y / (preview_count - 1);
+
+				set_preview_shape(a, preview_shapes[a], sf::Vector2f(i_queue_area.position.x + 0.5f * i_queue_area.size.x, i_queue_area.position.y + slot_height * (a - 0.5f)), queue_cell_size);
+			}
+			else
+			{
+				for (unsigned char b = 0; b < 4; b++)
+				{
+					batch.hide_quad(1 + 2 * width * height + 4 * a + b);
+				}
+			}
+		}
+	}
+}
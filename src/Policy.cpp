@@ -0,0 +1,157 @@
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <memory>
+#include <vector>
+
+#include "Global.hpp"
+#include "Board.hpp"
+#include "Tetromino.hpp"
+#include "Randomizer.hpp"
+#include "PieceQueue.hpp"
+#include "GameState.hpp"
+#include "ThreadPool.hpp"
+#include "MoveGenerator.hpp"
+#include "TranspositionTable.hpp"
+#include "Bot.hpp"
+#include "BatchFeatures.hpp"
+#include "Policy.hpp"
+
+Policy::Policy(const BotWeights& i_weights) :
+	weights(i_weights)
+{
+}
+
+void Policy::measure_placements(const std::vector<Placement>& i_placements, const Board& i_matrix, unsigned char i_shape, unsigned i_locked_rows)
+{
+	buffers.line_points.resize(i_placements.size());
+
+	buffers.matrices.assign(i_placements.size(), i_matrix);
+
+	for (std::size_t a = 0; a < i_placements.size(); a++)
+	{
+		buffers.line_points[a] = lock_placement(buffers.matrices[a], i_placements[a].minos, i_shape, i_locked_rows);
+	}
+
+	get_batch_features(buffers.matrices, buffers.line_points, i_locked_rows, buffers.features);
+}
+
+void Policy::reset(unsigned)
+{
+}
+
+const TranspositionTable* Policy::get_table() const
+{
+	return nullptr;
+}
+
+GreedyPolicy::GreedyPolicy(const BotWeights& i_weights) :
+	Policy(i_weights)
+{
+}
+
+Placement GreedyPolicy::choose(const GameState& i_game)
+{
+	std::size_t best = 0;
+
+	get_placements(i_game.tetromino, i_game.matrix, moves, placements);
+
+	measure_placements(placements, i_game.matrix, i_game.tetromino.get_shape(), i_game.locked_rows);
+
+	for (std::size_t a = 0; a < placements.size(); a++)
+	{
+		placements[a].score = evaluate_features(buffers.features[a], weights);
+
+		if (placements[best].score < placements[a].score)
+		{
+			best = a;
+		}
+	}
+
+	return placements[best];
+}
+
+LookaheadPolicy::LookaheadPolicy(const BotWeights& i_weights) :
+	Policy(i_weights),
+	table(BOT_TABLE_BITS)
+{
+}
+
+Placement LookaheadPolicy::choose(const GameState& i_game)
+{
+	std::size_t best = 0;
+
+	unsigned char next_shape = i_game.piece_queue.get(0);
+
+	get_placements(i_game.tetromino, i_game.matrix, moves, placements);
+
+	table.new_search();
+
+	//The same search as Bot::find_placement, on one thread since every thread already plays its own games.
+	for (std::size_t a = 0; a < placements.size(); a++)
+	{
+		Board matrix = i_game.matrix;
+
+		unsigned line_points = lock_placement(matrix, placements[a].minos, i_game.tetromino.get_shape(), i_game.locked_rows);
+
+		Tetromino next_tetromino(next_shape, matrix);
+
+		placements[a].score = TOP_OUT_SCORE;
+
+		if (1 == next_tetromino.reset(next_shape, matrix))
+		{
+			get_placements(next_tetromino, matrix, moves, next_placements);
+
+			placements[a].score = get_best_next_score(matrix, next_placements, next_shape, line_points, i_game.locked_rows, weights, table, buffers);
+		}
+
+		if (placements[best].score < placements[a].score)
+		{
+			best = a;
+		}
+	}
+
+	return placements[best];
+}
+
+const TranspositionTable* LookaheadPolicy::get_table() const
+{
+	return &table;
+}
+
+RandomPolicy::RandomPolicy(const BotWeights& i_weights) :
+	Policy(i_weights),
+	random_engine(0)
+{
+}
+
+Placement RandomPolicy::choose(const GameState& i_game)
+{
+	get_placements(i_game.tetromino, i_game.matrix, moves, placements);
+
+	return placements[random_engine.get_below(static_cast<unsigned>(placements.size()))];
+}
+
+void RandomPolicy::reset(unsigned i_seed)
+{
+	random_engine.seed(i_seed);
+}
+
+std::unique_ptr<Policy> make_policy(PolicyType i_type, const BotWeights& i_weights)
+{
+	switch (i_type)
+	{
+		case PolicyType::Lookahead:
+		{
+			return std::make_unique<LookaheadPolicy>(i_weights);
+		}
+		case PolicyType::Random:
+		{
+			return std::make_unique<RandomPolicy>(i_weights);
+		}
+		default:
+		{
+			return std::make_unique<GreedyPolicy>(i_weights);
+		}
+	}
+}
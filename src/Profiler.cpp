@@ -0,0 +1,203 @@
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <new>
+#include <sstream>
+#include <string>
+
+#include "Profiler.hpp"
+
+static std::atomic<unsigned long long> heap_allocations(0);
+
+//Every allocation in the program goes through here, so the profiler can count them.
+void* operator new(std::size_t i_size)
+{
+	heap_allocations.fetch_add(1, std::memory_order_relaxed);
+
+	while (1)
+	{
+		void* memory = std::malloc(0 == i_size ? 1 : i_size);
+
+		if (nullptr != memory)
+		{
+			return memory;
+		}
+
+		std::new_handler handler = std::get_new_handler();
+
+		if (nullptr == handler)
+		{
+			throw std::bad_alloc();
+		}
+
+		handler();
+	}
+}
+
+void operator delete(void* i_memory) noexcept
+{
+	std::free(i_memory);
+}
+
+void operator delete(void* i_memory, std::size_t) noexcept
+{
+	std::free(i_memory);
+}
+
+unsigned long long get_heap_allocation_count()
+{
+	return heap_allocations.load(std::memory_order_relaxed);
+}
+
+static double get_milliseconds(const std::chrono::microseconds& i_duration)
+{
+	return i_duration.count() / 1000.0;
+}
+
+Profiler::Profiler() :
+	started(0),
+	frame_count(0),
+	frame_start_allocations(0),
+	current_frame({})
+{
+	history.fill({});
+}
+
+bool Profiler::save_csv(const std::string& i_path) const
+{
+	std::ofstream file(i_path, std::ios::trunc);
+
+	file << "frame,frame_us,update_us,render_us,input_latency_us,draw_calls,heap_allocations,updates,late_updates\n";
+
+	//Oldest frame first.
+	for (unsigned a = frame_count < PROFILER_HISTORY ? 0 : frame_count - PROFILER_HISTORY; a < frame_count; a++)
+	{
+		const FrameProfile& frame = history[a % PROFILER_HISTORY];
+
+		file << a << ',' << frame.frame_time.count() << ',' << frame.update_time.count() << ',' << frame.render_time.count() << ',' << frame.input_latency.count() << ',' << frame.draw_calls << ',' << frame.heap_allocations << ',' << frame.updates << ',' << frame.late_updates << '\n';
+	}
+
+	return file.good();
+}
+
+std::string Profiler::get_overlay_text() const
+{
+	unsigned short frames = static_cast<unsigned short>(std::min<unsigned>(frame_count, PROFILER_OVERLAY_FRAMES));
+
+	if (0 == frames)
+	{
+		return "No frames yet";
+	}
+
+	unsigned catch_up_updates = 0;
+	unsigned short input_samples = 0;
+	unsigned total_updates = 0;
+
+	unsigned long long heap_allocations_sum = 0;
+
+	std::array<std::chrono::microseconds, PROFILER_OVERLAY_FRAMES> frame_times;
+
+	std::chrono::microseconds input_latency_max(0);
+	std::chrono::microseconds input_latency_sum(0);
+	std::chrono::microseconds render_time_sum(0);
+	std::chrono::microseconds update_time_sum(0);
+
+	for (unsigned short a = 0; a < frames; a++)
+	{
+		const FrameProfile& frame = history[(frame_count - 1 - a) % PROFILER_HISTORY];
+
+		catch_up_updates += frame.late_updates;
+		frame_times[a] = frame.frame_time;
+		heap_allocations_sum += frame.heap_allocations;
+		input_latency_max = std::max(input_latency_max, frame.input_latency);
+		input_latency_sum += frame.input_latency;
+		input_samples += 0 < frame.input_latency.count();
+		render_time_sum += frame.render_time;
+		total_updates += frame.updates;
+		update_time_sum += frame.update_time;
+	}
+
+	std::chrono::microseconds min_frame_time = *std::min_element(frame_times.begin(), frame_times.begin() + frames);
+	std::chrono::microseconds frame_time_sum(0);
+
+	for (unsigned short a = 0; a < frames; a++)
+	{
+		frame_time_sum += frame_times[a];
+	}
+
+	//The smallest frame time that at least 99% of the frames don't exceed.
+	unsigned short p99_index = static_cast<unsigned short>((99 * frames + 99) / 100 - 1);
+
+	std::nth_element(frame_times.begin(), frame_times.begin() + p99_index, frame_times.begin() + frames);
+
+	std::ostringstream text;
+
+	text << std::fixed << std::setprecision(1);
+	text << "Frame " << get_milliseconds(min_frame_time) << '/' << get_milliseconds(frame_time_sum) / frames << '/' << get_milliseconds(frame_times[p99_index]) << " ms\n";
+	text << std::setprecision(2);
+	text << "Update " << get_milliseconds(update_time_sum) / std::max(1u, total_updates) << " ms\n";
+	text << "Render " << get_milliseconds(render_time_sum) / frames << " ms\n";
+	text << std::setprecision(1);
+	text << "Input " << get_milliseconds(input_latency_sum) / std::max<unsigned short>(1, input_samples) << '/' << get_milliseconds(input_latency_max) << " ms\n";
+	text << std::setprecision(1);
+	text << "Draws " << history[(frame_count - 1) % PROFILER_HISTORY].draw_calls << '\n';
+	text << "Allocs " << static_cast<double>(heap_allocations_sum) / frames << "/frame\n";
+	text << "Catch-up " << catch_up_updates << '/' << total_updates;
+
+	return text.str();
+}
+
+void Profiler::begin_frame()
+{
+	std::chrono::time_point<std::chrono::steady_clock> now = std::chrono::steady_clock::now();
+
+	unsigned long long allocations = get_heap_allocation_count();
+
+	if (1 == started)
+	{
+		current_frame.frame_time = std::chrono::duration_cast<std::chrono::microseconds>(now - frame_start);
+		current_frame.heap_allocations = static_cast<unsigned>(allocations - frame_start_allocations);
+
+		history[frame_count % PROFILER_HISTORY] = current_frame;
+
+		frame_count++;
+	}
+
+	started = 1;
+
+	current_frame = {};
+
+	frame_start = now;
+	frame_start_allocations = allocations;
+}
+
+void Profiler::begin_section()
+{
+	section_start = std::chrono::steady_clock::now();
+}
+
+void Profiler::count_draw_call()
+{
+	current_frame.draw_calls++;
+}
+
+void Profiler::end_render()
+{
+	current_frame.render_time += std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - section_start);
+}
+
+void Profiler::set_input_latency(const std::chrono::microseconds& i_latency)
+{
+	current_frame.input_latency = i_latency;
+}
+
+void Profiler::add_updates(unsigned short i_updates, unsigned short i_late_updates, const std::chrono::microseconds& i_time)
+{
+	current_frame.late_updates += i_late_updates;
+	current_frame.updates += i_updates;
+	current_frame.update_time += i_time;
+}
@@ -0,0 +1,165 @@
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+#include "Randomizer.hpp"
+
+//How many times the history randomizer rerolls a shape that was dealt recently.
+constexpr unsigned char HISTORY_ROLLS = 6;
+
+static std::uint64_t rotate_left(std::uint64_t i_value, unsigned char i_shift)
+{
+	return (i_value << i_shift) | (i_value >> (64 - i_shift));
+}
+
+Xoshiro256::Xoshiro256(std::uint64_t i_seed)
+{
+	seed(i_seed);
+}
+
+unsigned Xoshiro256::get_below(unsigned i_bound)
+{
+	//Lemire's multiply and shift, rejecting the few values that would make some results more likely than others.
+	std::uint64_t product = ((*this)() >> 32) * i_bound;
+
+	if (static_cast<std::uint32_t>(product) < i_bound)
+	{
+		std::uint32_t threshold = static_cast<std::uint32_t>(-i_bound) % i_bound;
+
+		while (static_cast<std::uint32_t>(product) < threshold)
+		{
+			product = ((*this)() >> 32) * i_bound;
+		}
+	}
+
+	return static_cast<unsigned>(product >> 32);
+}
+
+std::uint64_t Xoshiro256::operator()()
+{
+	std::uint64_t result = 9 * rotate_left(5 * state[1], 7);
+	std::uint64_t shifted = state[1] << 17;
+
+	state[2] ^= state[0];
+	state[3] ^= state[1];
+	state[1] ^= state[2];
+	state[0] ^= state[3];
+	state[2] ^= shifted;
+	state[3] = rotate_left(state[3], 45);
+
+	return result;
+}
+
+void Xoshiro256::seed(std::uint64_t i_seed)
+{
+	//The state is filled with SplitMix64, so that even similar seeds give unrelated sequences.
+	for (std::uint64_t& word : state)
+	{
+		i_seed += 0x9e3779b97f4a7c15;
+
+		std::uint64_t mixed = i_seed;
+
+		mixed = (mixed ^ (mixed >> 30)) * 0xbf58476d1ce4e5b9;
+		mixed = (mixed ^ (mixed >> 27)) * 0x94d049bb133111eb;
+
+		word = mixed ^ (mixed >> 31);
+	}
+}
+
+Randomizer::Randomizer(unsigned char i_shapes, unsigned i_seed) :
+	shapes(i_shapes),
+	random_engine(i_seed)
+{
+}
+
+UniformRandomizer::UniformRandomizer(unsigned char i_shapes, unsigned i_seed) :
+	Randomizer(i_shapes, i_seed)
+{
+}
+
+unsigned char UniformRandomizer::next()
+{
+	return static_cast<unsigned char>(random_engine.get_below(shapes));
+}
+
+BagRandomizer::BagRandomizer(unsigned char i_shapes, unsigned char i_copies, unsigned i_seed) :
+	Randomizer(i_shapes, i_seed),
+	bag_size(i_shapes * i_copies),
+	next_index(i_shapes * i_copies)
+{
+}
+
+unsigned char BagRandomizer::next()
+{
+	if (bag_size == next_index)
+	{
+		next_index = 0;
+
+		for (unsigned char a = 0; a < bag_size; a++)
+		{
+			bag[a] = a % shapes;
+		}
+
+		//Fisher-Yates.
+		for (unsigned char a = bag_size - 1; 0 < a; a--)
+		{
+			std::swap(bag[a], bag[random_engine.get_below(1 + a)]);
+		}
+	}
+
+	return bag[next_index++];
+}
+
+HistoryRandomizer::HistoryRandomizer(unsigned char i_shapes, unsigned i_seed) :
+	Randomizer(i_shapes, i_seed),
+	oldest_index(0)
+{
+	//No shape has been dealt yet.
+	history.fill(255);
+}
+
+unsigned char HistoryRandomizer::next()
+{
+	unsigned char shape = 0;
+
+	for (unsigned char a = 0; a < HISTORY_ROLLS; a++)
+	{
+		shape = static_cast<unsigned char>(random_engine.get_below(shapes));
+
+		if (history.end() == std::find(history.begin(), history.end(), shape))
+		{
+			break;
+		}
+	}
+
+	history[oldest_index] = shape;
+
+	oldest_index = (1 + oldest_index) % history.size();
+
+	return shape;
+}
+
+std::unique_ptr<Randomizer> make_randomizer(RandomizerType i_type, unsigned char i_shapes, unsigned i_seed)
+{
+	switch (i_type)
+	{
+		case RandomizerType::Bag:
+		{
+			return std::make_unique<BagRandomizer>(i_shapes, 1, i_seed);
+		}
+		case RandomizerType::DoubleBag:
+		{
+			return std::make_unique<BagRandomizer>(i_shapes, 2, i_seed);
+		}
+		case RandomizerType::History:
+		{
+			return std::make_unique<HistoryRandomizer>(i_shapes, i_seed);
+		}
+		default:
+		{
+			return std::make_unique<UniformRandomizer>(i_shapes, i_seed);
+		}
+	}
+}
@@ -0,0 +1,328 @@
+#include <array>
+#include <chrono>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Global.hpp"
+#include "Board.hpp"
+#include "Tetromino.hpp"
+#include "Randomizer.hpp"
+#include "PieceQueue.hpp"
+#include "GameState.hpp"
+#include "Replay.hpp"
+
+//The file starts with the magic and the version, followed by the header, then the inputs as runs of identical frames.
+//Since version 4 the header has the soft drop factor, the DAS and the ARR, and the key events follow the inputs.
+//Every event is the number of frames since the previous one, a byte with the key and 128 if it was pressed, then its time in the frame.
+//All the numbers are little endian, and the run lengths, frame gaps and times are variable-length integers (7 bits per byte).
+//Version 3 replays play the same with the default handling. Replays made before it used a random engine that we no longer have.
+constexpr std::array<char, 4> REPLAY_MAGIC = {'T', 'R', 'P', 'L'};
+constexpr unsigned char REPLAY_VERSION = 4;
+constexpr unsigned char REPLAY_OLDEST_VERSION = 3;
+
+static void write_u32(std::vector<unsigned char>& i_bytes, unsigned i_value)
+{
+	for (unsigned char a = 0; a < 4; a++)
+	{
+		i_bytes.push_back(static_cast<unsigned char>(i_value >> (8 * a)));
+	}
+}
+
+static void write_varint(std::vector<unsigned char>& i_bytes, unsigned i_value)
+{
+	while (128 <= i_value)
+	{
+		i_bytes.push_back(static_cast<unsigned char>(128 | (i_value & 127)));
+
+		i_value >>= 7;
+	}
+
+	i_bytes.push_back(static_cast<unsigned char>(i_value));
+}
+
+static bool read_u32(const std::vector<unsigned char>& i_bytes, std::size_t& i_offset, unsigned& i_value)
+{
+	if (i_bytes.size() < 4 + i_offset)
+	{
+		return 0;
+	}
+
+	i_value = 0;
+
+	for (unsigned char a = 0; a < 4; a++)
+	{
+		i_value |= static_cast<unsigned>(i_bytes[i_offset++]) << (8 * a);
+	}
+
+	return 1;
+}
+
+static bool read_varint(const std::vector<unsigned char>& i_bytes, std::size_t& i_offset, unsigned& i_value)
+{
+	i_value = 0;
+
+	for (unsigned char a = 0; a < 5; a++)
+	{
+		if (i_bytes.size() <= i_offset)
+		{
+			return 0;
+		}
+
+		unsigned char byte = i_bytes[i_offset++];
+
+		i_value |= static_cast<unsigned>(byte & 127) << (7 * a);
+
+		if (0 == (byte & 128))
+		{
+			return 1;
+		}
+	}
+
+	return 0;
+}
+
+static std::vector<unsigned char> encode_replay(const Replay& i_replay)
+{
+	std::vector<unsigned char> bytes(REPLAY_MAGIC.begin(), REPLAY_MAGIC.end());
+
+	bytes.push_back(REPLAY_VERSION);
+	bytes.push_back(i_replay.advanced_mode);
+	bytes.push_back(i_replay.board_width);
+	bytes.push_back(i_replay.board_height);
+	bytes.push_back(static_cast<unsigned char>(i_replay.randomizer_type));
+	bytes.push_back(i_replay.soft_drop_factor);
+
+	write_u32(bytes, i_replay.seed);
+	write_u32(bytes, i_replay.final_score);
+	write_u32(bytes, i_replay.final_lines);
+	write_u32(bytes, i_replay.das);
+	write_u32(bytes, i_replay.arr);
+	write_u32(bytes, static_cast<unsigned>(i_replay.inputs.size()));
+
+	for (std::size_t a = 0; a < i_replay.inputs.size();)
+	{
+		std::size_t run_end = 1 + a;
+
+		while (run_end < i_replay.inputs.size() && i_replay.inputs[a] == i_replay.inputs[run_end])
+		{
+			run_end++;
+		}
+
+		bytes.push_back(i_replay.inputs[a]);
+
+		write_varint(bytes, static_cast<unsigned>(run_end - a));
+
+		a = run_end;
+	}
+
+	write_u32(bytes, static_cast<unsigned>(i_replay.events.size()));
+
+	unsigned frame = 0;
+
+	for (const ReplayEvent& event : i_replay.events)
+	{
+		write_varint(bytes, event.frame - frame);
+
+		bytes.push_back(static_cast<unsigned char>((1 == event.event.pressed ? 128 : 0) | event.event.key));
+
+		write_varint(bytes, event.event.time);
+
+		frame = event.frame;
+	}
+
+	return bytes;
+}
+
+unsigned long long hash_replay(const Replay& i_replay)
+{
+	//64-bit FNV-1a.
+	unsigned long long hash = 14695981039346656037ull;
+
+	for (unsigned char byte : encode_replay(i_replay))
+	{
+		hash = 1099511628211ull * (hash ^ byte);
+	}
+
+	return hash;
+}
+
+bool load_replay(const std::string& i_path, Replay& i_replay)
+{
+	std::ifstream file(i_path, std::ios::binary);
+
+	if (0 == file.is_open())
+	{
+		return 0;
+	}
+
+	std::vector<unsigned char> bytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+	std::size_t offset = REPLAY_MAGIC.size() + 5;
+
+	unsigned char version = 0;
+
+	unsigned event_count = 0;
+	unsigned frame_count = 0;
+
+	if (bytes.size() < 1 + offset || 0 == std::equal(REPLAY_MAGIC.begin(), REPLAY_MAGIC.end(), bytes.begin()) || REPLAY_OLDEST_VERSION > bytes[REPLAY_MAGIC.size()] || REPLAY_VERSION < bytes[REPLAY_MAGIC.size()] || static_cast<unsigned char>(RandomizerType::History) < bytes[4 + REPLAY_MAGIC.size()])
+	{
+		return 0;
+	}
+
+	version = bytes[REPLAY_MAGIC.size()];
+
+	i_replay.advanced_mode = 0 != bytes[1 + REPLAY_MAGIC.size()];
+	i_replay.board_width = bytes[2 + REPLAY_MAGIC.size()];
+	i_replay.board_height = bytes[3 + REPLAY_MAGIC.size()];
+	i_replay.randomizer_type = static_cast<RandomizerType>(bytes[4 + REPLAY_MAGIC.size()]);
+
+	i_replay.soft_drop_factor = DEFAULT_SOFT_DROP_FACTOR;
+	i_replay.arr = DEFAULT_ARR;
+	i_replay.das = DEFAULT_DAS;
+
+	if (REPLAY_OLDEST_VERSION < version)
+	{
+		i_replay.soft_drop_factor = bytes[offset++];
+	}
+
+	if (0 == read_u32(bytes, offset, i_replay.seed) || 0 == read_u32(bytes, offset, i_replay.final_score) || 0 == read_u32(bytes, offset, i_replay.final_lines))
+	{
+		return 0;
+	}
+
+	if (REPLAY_OLDEST_VERSION < version && (0 == read_u32(bytes, offset, i_replay.das) || 0 == read_u32(bytes, offset, i_replay.arr)))
+	{
+		return 0;
+	}
+
+	if (0 == read_u32(bytes, offset, frame_count))
+	{
+		return 0;
+	}
+
+	i_replay.inputs.clear();
+	i_replay.inputs.reserve(frame_count);
+
+	while (i_replay.inputs.size() < frame_count)
+	{
+		unsigned run_length = 0;
+
+		if (bytes.size() <= offset)
+		{
+			return 0;
+		}
+
+		unsigned char keys = bytes[offset++];
+
+		if (0 == read_varint(bytes, offset, run_length) || frame_count - i_replay.inputs.size() < run_length)
+		{
+			return 0;
+		}
+
+		i_replay.inputs.insert(i_replay.inputs.end(), run_length, keys);
+	}
+
+	i_replay.events.clear();
+
+	if (REPLAY_OLDEST_VERSION == version)
+	{
+		return 1;
+	}
+
+	if (0 == read_u32(bytes, offset, event_count))
+	{
+		return 0;
+	}
+
+	unsigned frame = 0;
+	unsigned frame_events = 0;
+
+	for (unsigned a = 0; a < event_count; a++)
+	{
+		unsigned frame_gap = 0;
+		unsigned time = 0;
+
+		if (0 == read_varint(bytes, offset, frame_gap) || bytes.size() <= offset)
+		{
+			return 0;
+		}
+
+		unsigned char key = bytes[offset++];
+
+		if (0 == read_varint(bytes, offset, time))
+		{
+			return 0;
+		}
+
+		frame_events = 0 == frame_gap ? 1 + frame_events : 1;
+		frame += frame_gap;
+
+		bool pressed = 0 != (128 & key);
+
+		key &= 127;
+
+		//One real key per event, inside a frame that exists, and no more events per frame than an InputFrame holds.
+		if (frame_count <= frame || FRAME_DURATION <= time || 0 == key || INPUT_PAUSE <= key || 0 != (key & (key - 1)) || MAX_INPUT_EVENTS < frame_events)
+		{
+			return 0;
+		}
+
+		i_replay.events.push_back({frame, {pressed, key, static_cast<unsigned short>(time)}});
+	}
+
+	return 1;
+}
+
+void record_replay_frame(const InputFrame& i_input, Replay& i_replay)
+{
+	for (unsigned char a = 0; a < i_input.event_count; a++)
+	{
+		i_replay.events.push_back({static_cast<unsigned>(i_replay.inputs.size()), i_input.events[a]});
+	}
+
+	i_replay.inputs.push_back(i_input.keys);
+}
+
+bool save_replay(const std::string& i_path, const Replay& i_replay)
+{
+	std::vector<unsigned char> bytes = encode_replay(i_replay);
+
+	std::ofstream file(i_path, std::ios::binary | std::ios::trunc);
+
+	file.write(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+
+	return file.good();
+}
+
+InputFrame get_replay_frame(const Replay& i_replay, std::size_t i_frame, std::size_t& i_next_event)
+{
+	InputFrame frame = {};
+	frame.keys = i_replay.inputs[i_frame];
+
+	while (i_next_event < i_replay.events.size() && i_frame == i_replay.events[i_next_event].frame)
+	{
+		frame.events[frame.event_count++] = i_replay.events[i_next_event++].event;
+	}
+
+	return frame;
+}
+
+void simulate_replay(const Replay& i_replay, GameState& i_game)
+{
+	std::size_t next_event = 0;
+
+	i_game.arr = i_replay.arr;
+	i_game.das = i_replay.das;
+	i_game.randomizer_type = i_replay.randomizer_type;
+	i_game.soft_drop_factor = i_replay.soft_drop_factor;
+	i_game.resize(i_replay.board_width, i_replay.board_height);
+	i_game.reset(i_replay.advanced_mode, i_replay.seed);
+
+	for (std::size_t a = 0; a < i_replay.inputs.size(); a++)
+	{
+		i_game.step(get_replay_frame(i_replay, a, next_event));
+	}
+}
@@ -0,0 +1,64 @@
+#include <array>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Global.hpp"
+#include "Board.hpp"
+#include "Tetromino.hpp"
+#include "Randomizer.hpp"
+#include "PieceQueue.hpp"
+#include "GameState.hpp"
+#include "Replay.hpp"
+
+//Re-simulates recorded games without a window and checks that they still end with the same score and lines.
+int main(int i_argument_count, char** i_arguments)
+{
+	if (3 > i_argument_count || std::string("--replay-verify") != i_arguments[1])
+	{
+		std::cerr << "Usage: " << i_arguments[0] << " --replay-verify <replay file>..." << std::endl;
+
+		return 2;
+	}
+
+	unsigned failed = 0;
+
+	unsigned long long total_frames = 0;
+
+	std::chrono::time_point<std::chrono::steady_clock> start_time = std::chrono::steady_clock::now();
+
+	GameState game(0);
+
+	for (int a = 2; a < i_argument_count; a++)
+	{
+		Replay replay;
+
+		if (0 == load_replay(i_arguments[a], replay))
+		{
+			std::cerr << i_arguments[a] << ": can't read the replay" << std::endl;
+
+			failed++;
+
+			continue;
+		}
+
+		simulate_replay(replay, game);
+
+		total_frames += replay.inputs.size();
+
+		if (game.score != replay.final_score || game.lines_cleared != replay.final_lines)
+		{
+			std::cerr << i_arguments[a] << ": expected score " << replay.final_score << " and " << replay.final_lines << " lines, got score " << game.score << " and " << game.lines_cleared << " lines" << std::endl;
+
+			failed++;
+		}
+	}
+
+	double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count();
+
+	std::cout << i_argument_count - 2 - failed << " of " << i_argument_count - 2 << " replays match, " << total_frames << " frames in " << seconds << " s" << std::endl;
+
+	return 0 == failed ? 0 : 1;
+}
@@ -0,0 +1,281 @@
+#include <algorithm>
+#include <array>
+#include <fstream>
+#include <functional>
+#include <iterator>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "DurableFile.hpp"
+#include "IoWorker.hpp"
+#include "ScoreLog.hpp"
+
+//The file starts with the magic and the version, followed by records of a fixed size.
+//Every record is the mode, the duration, level, lines and score, the replay hash and the time, then a CRC-32 of all of those.
+//All the numbers are little endian.
+constexpr std::array<char, 4> SCORE_LOG_MAGIC = {'T', 'S', 'C', 'L'};
+constexpr unsigned char SCORE_LOG_VERSION = 1;
+constexpr unsigned char SCORE_LOG_HEADER_SIZE = 1 + SCORE_LOG_MAGIC.size();
+constexpr unsigned char SCORE_RECORD_SIZE = 37;
+
+static void write_u32(std::vector<unsigned char>& i_bytes, unsigned i_value)
+{
+	for (unsigned char a = 0; a < 4; a++)
+	{
+		i_bytes.push_back(static_cast<unsigned char>(i_value >> (8 * a)));
+	}
+}
+
+static void write_u64(std::vector<unsigned char>& i_bytes, unsigned long long i_value)
+{
+	write_u32(i_bytes, static_cast<unsigned>(i_value));
+	write_u32(i_bytes, static_cast<unsigned>(i_value >> 32));
+}
+
+static unsigned read_u32(const unsigned char* i_bytes)
+{
+	unsigned value = 0;
+
+	for (unsigned char a = 0; a < 4; a++)
+	{
+		value |= static_cast<unsigned>(i_bytes[a]) << (8 * a);
+	}
+
+	return value;
+}
+
+static unsigned long long read_u64(const unsigned char* i_bytes)
+{
+	return read_u32(i_bytes) | static_cast<unsigned long long>(read_u32(4 + i_bytes)) << 32;
+}
+
+static unsigned get_crc32(const unsigned char* i_bytes, std::size_t i_size)
+{
+	unsigned crc = 0xffffffff;
+
+	for (std::size_t a = 0; a < i_size; a++)
+	{
+		crc ^= i_bytes[a];
+
+		for (unsigned char b = 0; b < 8; b++)
+		{
+			crc = (crc >> 1) ^ (0xedb88320 & (0 - (crc & 1)));
+		}
+	}
+
+	return ~crc;
+}
+
+static void write_record(std::vector<unsigned char>& i_bytes, const ScoreRecord& i_record)
+{
+	std::size_t start = i_bytes.size();
+
+	i_bytes.push_back(i_record.mode);
+
+	write_u32(i_bytes, i_record.duration);
+	write_u32(i_bytes, i_record.level);
+	write_u32(i_bytes, i_record.lines);
+	write_u32(i_bytes, i_record.score);
+	write_u64(i_bytes, i_record.replay_hash);
+	write_u64(i_bytes, i_record.time);
+	write_u32(i_bytes, get_crc32(start + i_bytes.data(), i_bytes.size() - start));
+}
+
+static bool read_record(const unsigned char* i_bytes, ScoreRecord& i_record)
+{
+	if (get_crc32(i_bytes, SCORE_RECORD_SIZE - 4) != read_u32(SCORE_RECORD_SIZE - 4 + i_bytes) || SCORE_MODE_COUNT <= i_bytes[0])
+	{
+		return 0;
+	}
+
+	i_record.mode = i_bytes[0];
+	i_record.duration = read_u32(1 + i_bytes);
+	i_record.level = read_u32(5 + i_bytes);
+	i_record.lines = read_u32(9 + i_bytes);
+	i_record.score = read_u32(13 + i_bytes);
+	i_record.replay_hash = read_u64(17 + i_bytes);
+	i_record.time = read_u64(25 + i_bytes);
+
+	return 1;
+}
+
+//Keeps the tables sorted from the best score, with older games first among equal scores.
+static void insert_record(std::array<std::vector<ScoreRecord>, SCORE_MODE_COUNT>& i_tables, const ScoreRecord& i_record)
+{
+	std::vector<ScoreRecord>& table = i_tables[i_record.mode];
+
+	table.insert(std::upper_bound(table.begin(), table.end(), i_record, [](const ScoreRecord& i_a, const ScoreRecord& i_b)
+	{
+		return i_a.score > i_b.score;
+	}), i_record);
+
+	if (SCORE_TABLE_SIZE < table.size())
+	{
+		table.resize(SCORE_TABLE_SIZE);
+	}
+}
+
+ScoreLog::ScoreLog(const std::string& i_path, IoWorker& i_io_worker) :
+	needs_compaction(0),
+	path(i_path),
+	io_worker(i_io_worker)
+{
+}
+
+ScoreLog::~ScoreLog()
+{
+	io_worker.wait();
+}
+
+bool ScoreLog::load()
+{
+	std::ifstream file(path, std::ios::binary);
+
+	if (0 == file.is_open())
+	{
+		return 0;
+	}
+
+	std::vector<unsigned char> bytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+	//A damaged header doesn't stop us from reading the records, since every one of them is checked anyway.
+	bool damaged = bytes.size() < SCORE_LOG_HEADER_SIZE || 0 == std::equal(SCORE_LOG_MAGIC.begin(), SCORE_LOG_MAGIC.end(), bytes.begin()) || SCORE_LOG_VERSION != bytes[SCORE_LOG_MAGIC.size()];
+
+	std::size_t offset = SCORE_LOG_HEADER_SIZE;
+
+	std::lock_guard<std::mutex> lock(mutex);
+
+	records.clear();
+
+	for (std::vector<ScoreRecord>& table : tables)
+	{
+		table.clear();
+	}
+
+	for (; offset + SCORE_RECORD_SIZE <= bytes.size(); offset += SCORE_RECORD_SIZE)
+	{
+		ScoreRecord record;
+
+		if (0 == read_record(offset + bytes.data(), record))
+		{
+			damaged = 1;
+
+			continue;
+		}
+
+		insert_record(tables, record);
+
+		records.push_back(record);
+	}
+
+	//A record that was cut short would throw every record appended after it out of step.
+	if (offset < bytes.size())
+	{
+		damaged = 1;
+	}
+
+	needs_compaction = damaged;
+
+	if (1 == damaged)
+	{
+		io_worker.push([this]()
+		{
+			compact();
+		});
+	}
+
+	return 1;
+}
+
+void ScoreLog::get_table(unsigned char i_mode, std::vector<ScoreRecord>& i_table) const
+{
+	std::lock_guard<std::mutex> lock(mutex);
+
+	i_table = tables[i_mode];
+}
+
+void ScoreLog::add(const ScoreRecord& i_record)
+{
+	if (SCORE_MODE_COUNT <= i_record.mode)
+	{
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+
+		insert_record(tables, i_record);
+	}
+
+	io_worker.push([this, i_record]()
+	{
+		append(i_record);
+	});
+}
+
+void ScoreLog::append(const ScoreRecord& i_record)
+{
+	records.push_back(i_record);
+
+	//The record is written along with the ones that are missing.
+	if (1 == needs_compaction)
+	{
+		compact();
+
+		return;
+	}
+
+	int descriptor = open_for_writing(path, 1);
+
+	if (0 > descriptor)
+	{
+		needs_compaction = 1;
+
+		return;
+	}
+
+	long long size = get_file_size(descriptor);
+
+	std::vector<unsigned char> bytes;
+
+	if (0 == size)
+	{
+		bytes.assign(SCORE_LOG_MAGIC.begin(), SCORE_LOG_MAGIC.end());
+		bytes.push_back(SCORE_LOG_VERSION);
+	}
+
+	write_record(bytes, i_record);
+
+	if (0 > size || 0 == write_all(descriptor, bytes) || 0 == sync_file(descriptor))
+	{
+		//Not leaving half a record behind.
+		if (0 <= size)
+		{
+			truncate_file(descriptor, size);
+		}
+
+		//The next write saves the record with a compaction.
+		needs_compaction = 1;
+	}
+
+	close_file(descriptor);
+}
+
+void ScoreLog::compact()
+{
+	std::vector<unsigned char> bytes(SCORE_LOG_MAGIC.begin(), SCORE_LOG_MAGIC.end());
+
+	bytes.push_back(SCORE_LOG_VERSION);
+
+	for (const ScoreRecord& record : records)
+	{
+		write_record(bytes, record);
+	}
+
+	//The old log stays untouched until the new one is safely on the disk.
+	if (1 == replace_file_contents(path, bytes))
+	{
+		needs_compaction = 0;
+	}
+}
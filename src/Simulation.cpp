@@ -0,0 +1,75 @@
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <vector>
+
+#include "Global.hpp"
+#include "Board.hpp"
+#include "Tetromino.hpp"
+#include "Randomizer.hpp"
+#include "PieceQueue.hpp"
+#include "GameState.hpp"
+#include "ThreadPool.hpp"
+#include "MoveGenerator.hpp"
+#include "TranspositionTable.hpp"
+#include "Bot.hpp"
+#include "Policy.hpp"
+#include "Simulation.hpp"
+
+GameResult simulate_game(const SimulationSettings& i_settings, unsigned i_seed, Policy& i_policy, GameState& i_game)
+{
+	i_game.reset(i_settings.advanced_mode, i_seed);
+
+	i_policy.reset(i_seed);
+
+	const TranspositionTable* table = i_policy.get_table();
+
+	unsigned long long start_hits = nullptr == table ? 0 : table->get_hits();
+	unsigned long long start_misses = nullptr == table ? 0 : table->get_misses();
+
+	while (0 == i_game.game_over && (0 == i_settings.max_pieces || i_game.pieces_placed < i_settings.max_pieces))
+	{
+		i_game.place(i_policy.choose(i_game).minos, i_settings.piece_frames);
+	}
+
+	if (nullptr == table)
+	{
+		return {i_game.lines_cleared, i_game.pieces_placed, i_game.score, 0, 0};
+	}
+
+	return {i_game.lines_cleared, i_game.pieces_placed, i_game.score, table->get_hits() - start_hits, table->get_misses() - start_misses};
+}
+
+std::vector<GameResult> simulate_games(const SimulationSettings& i_settings, unsigned i_first_seed, unsigned i_game_count, ThreadPool& i_thread_pool)
+{
+	std::atomic<unsigned> next_game(0);
+
+	std::vector<GameResult> results(i_game_count);
+
+	//One task per thread, each taking the next game until there are none left, since some games last far longer than others.
+	for (unsigned a = 0; a < std::min(i_game_count, i_thread_pool.get_thread_count()); a++)
+	{
+		i_thread_pool.push([&i_settings, i_first_seed, i_game_count, &next_game, &results]()
+		{
+			//Made once per task, so that the games don't allocate.
+			GameState game(0);
+
+			std::unique_ptr<Policy> policy = make_policy(i_settings.policy_type, i_settings.weights);
+
+			game.randomizer_type = i_settings.randomizer_type;
+
+			game.resize(i_settings.board_width, i_settings.board_height);
+
+			for (unsigned b = next_game++; b < i_game_count; b = next_game++)
+			{
+				results[b] = simulate_game(i_settings, i_first_seed + b, *policy, game);
+			}
+		});
+	}
+
+	i_thread_pool.wait();
+
+	return results;
+}
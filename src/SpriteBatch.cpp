@@ -0,0 +1,82 @@
+#include <SFML/Graphics.hpp>
+
+#include "SpriteBatch.hpp"
+
+//Every quad is made of 2 triangles.
+constexpr unsigned char QUAD_VERTICES = 6;
+
+SpriteBatch::SpriteBatch() :
+	texture(nullptr),
+	vertices(sf::PrimitiveType::Triangles)
+{
+}
+
+void SpriteBatch::draw(sf::RenderTarget& i_target, sf::RenderStates i_states) const
+{
+	i_states.texture = texture;
+
+	i_target.draw(vertices, i_states);
+}
+
+unsigned short SpriteBatch::get_quad_count() const
+{
+	return static_cast<unsigned short>(vertices.getVertexCount() / QUAD_VERTICES);
+}
+
+void SpriteBatch::hide_quad(unsigned short i_index)
+{
+	sf::Vertex* quad = &vertices[QUAD_VERTICES * i_index];
+
+	for (unsigned char a = 0; a < QUAD_VERTICES; a++)
+	{
+		quad[a].color = sf::Color::Transparent;
+		quad[a].position = sf::Vector2f(0, 0);
+	}
+}
+
+void SpriteBatch::resize(unsigned short i_quad_count)
+{
+	vertices.resize(QUAD_VERTICES * i_quad_count);
+
+	for (unsigned short a = 0; a < i_quad_count; a++)
+	{
+		hide_quad(a);
+	}
+}
+
+void SpriteBatch::set_quad(unsigned short i_index, const sf::FloatRect& i_position, const sf::IntRect& i_texture_rect, const sf::Color& i_color)
+{
+	float left = i_position.position.x;
+	float top = i_position.position.y;
+	float right = left + i_position.size.x;
+	float bottom = top + i_position.size.y;
+
+	float texture_left = static_cast<float>(i_texture_rect.position.x);
+	float texture_top = static_cast<float>(i_texture_rect.position.y);
+	float texture_right = texture_left + i_texture_rect.size.x;
+	float texture_bottom = texture_top + i_texture_rect.size.y;
+
+	sf::Vertex* quad = &vertices[QUAD_VERTICES * i_index];
+
+	quad[0] = {sf::Vector2f(left, top), i_color, sf::Vector2f(texture_left, texture_top)};
+	quad[1] = {sf::Vector2f(right, top), i_color, sf::Vector2f(texture_right, texture_top)};
+	quad[2] = {sf::Vector2f(left, bottom), i_color, sf::Vector2f(texture_left, texture_bottom)};
+	quad[3] = {sf::Vector2f(left, bottom), i_color, sf::Vector2f(texture_left, texture_bottom)};
+	quad[4] = {sf::Vector2f(right, top), i_color, sf::Vector2f(texture_right, texture_top)};
+	quad[5] = {sf::Vector2f(right, bottom), i_color, sf::Vector2f(texture_right, texture_bottom)};
+}
+
+void SpriteBatch::set_quad_color(unsigned short i_index, const sf::Color& i_color)
+{
+	sf::Vertex* quad = &vertices[QUAD_VERTICES * i_index];
+
+	for (unsigned char a = 0; a < QUAD_VERTICES; a++)
+	{
+		quad[a].color = i_color;
+	}
+}
+
+void SpriteBatch::set_texture(const sf::Texture& i_texture)
+{
+	texture = &i_texture;
+}
@@ -1,30 +1,27 @@
-#include <vector>
+#include <array>
 
-#include "Headers/Global.hpp"
-#include "Headers/GetTetromino.hpp"
-#include "Headers/GetWallKickData.hpp"
-#include "Headers/Tetromino.hpp"
+#include "Global.hpp"
+#include "Board.hpp"
+#include "GetTetromino.hpp"
+#include "GetWallKickData.hpp"
+#include "RotationTable.hpp"
+#include "Tetromino.hpp"
 
-Tetromino::Tetromino(unsigned char i_shape, const std::vector<std::vector<unsigned char>>& i_matrix) :
+Tetromino::Tetromino(unsigned char i_shape, const Board& i_matrix) :
+	ghost_valid(0),
 	rotation(0),
 	shape(i_shape),
-	minos(get_tetromino(i_shape, COLUMNS / 2, 1))
+	ghost_revision(0),
+	ghost_matrix(nullptr),
+	minos(get_tetromino(i_shape, i_matrix.get_width() / 2, 1))
 {
 }
 
-bool Tetromino::move_down(const std::vector<std::vector<unsigned char>>& i_matrix)
+bool Tetromino::move_down(const Board& i_matrix)
 {
-	for (Position& mino : minos)
+	if (1 == i_matrix.collides(minos, 0, 1))
 	{
-		if (ROWS == 1 + mino.y)
-		{
-			return 0;
-		}
-
-		if (0 < i_matrix[mino.x][1 + mino.y])
-		{
-			return 0;
-		}
+		return 0;
 	}
 
 	for (Position& mino : minos)
@@ -35,197 +32,93 @@ bool Tetromino::move_down(const std::vector<std::vector<unsigned char>>& i_matri
 	return 1;
 }
 
-bool Tetromino::reset(unsigned char i_shape, const std::vector<std::vector<unsigned char>>& i_matrix)
+bool Tetromino::reset(unsigned char i_shape, const Board& i_matrix)
 {
+	ghost_valid = 0;
+
 	rotation = 0;
 	shape = i_shape;
 
-	minos = get_tetromino(shape, COLUMNS / 2, 1);
+	minos = get_tetromino(shape, i_matrix.get_width() / 2, 1);
 
-	for (Position& mino : minos)
-	{
-		if (0 < i_matrix[mino.x][mino.y])
-		{
-			return 0;
-		}
-	}
+	return 0 == i_matrix.collides(minos, 0, 0);
+}
 
-	return 1;
+unsigned char Tetromino::get_rotation() const
+{
+	return rotation;
 }
 
-unsigned char Tetromino::get_shape()
+unsigned char Tetromino::get_shape() const
 {
 	return shape;
 }
 
-void Tetromino::hard_drop(const std::vector<std::vector<unsigned char>>& i_matrix)
+void Tetromino::hard_drop(const Board& i_matrix)
 {
 	minos = get_ghost_minos(i_matrix);
 }
 
-void Tetromino::move_left(const std::vector<std::vector<unsigned char>>& i_matrix)
+bool Tetromino::move_left(const Board& i_matrix)
 {
-	for (Position& mino : minos)
+	if (1 == i_matrix.collides(minos, -1, 0))
 	{
-		if (0 > mino.x - 1)
-		{
-			return;
-		}
-
-		if (0 > mino.y)
-		{
-			continue;
-		}
-		else if (0 < i_matrix[mino.x - 1][mino.y])
-		{
-			return;
-		}
+		return 0;
 	}
 
+	ghost_valid = 0;
+
 	for (Position& mino : minos)
 	{
 		mino.x--;
 	}
+
+	return 1;
 }
 
-void Tetromino::move_right(const std::vector<std::vector<unsigned char>>& i_matrix)
+bool Tetromino::move_right(const Board& i_matrix)
 {
-	for (Position& mino : minos)
+	if (1 == i_matrix.collides(minos, 1, 0))
 	{
-		if (COLUMNS == 1 + mino.x)
-		{
-			return;
-		}
-
-		if (0 > mino.y)
-		{
-			continue;
-		}
-		else if (0 < i_matrix[1 + mino.x][mino.y])
-		{
-			return;
-		}
+		return 0;
 	}
 
+	ghost_valid = 0;
+
 	for (Position& mino : minos)
 	{
 		mino.x++;
 	}
+
+	return 1;
 }
 
-void Tetromino::rotate(bool i_clockwise, const std::vector<std::vector<unsigned char>>& i_matrix)
+bool Tetromino::rotate(bool i_clockwise, const Board& i_matrix)
 {
 	if (3 != shape)
 	{
-		unsigned char next_rotation;
-
-		std::vector<Position> current_minos = minos;
+		const Rotation& turn = ROTATION_TABLE[shape][rotation][i_clockwise];
 
-		if (0 == i_clockwise)
+		for (unsigned char a = 0; a < minos.size(); a++)
 		{
-			next_rotation = (3 + rotation) % 4;
-		}
-		else
-		{
-			next_rotation = (1 + rotation) % 4;
+			minos[a].x += turn.minos[a].x;
+			minos[a].y += turn.minos[a].y;
 		}
 
-		if (0 == shape)
+		for (const Position& wall_kick : turn.wall_kicks)
 		{
-			float center_x = 0.5f * (minos[1].x + minos[2].x);
-			float center_y = 0.5f * (minos[1].y + minos[2].y);
-
-			switch (rotation)
+			if (0 == i_matrix.collides(minos, wall_kick.x, wall_kick.y))
 			{
-				case 0:
-				{
-					center_y += 0.5f;
-
-					break;
-				}
-				case 1:
-				{
-					center_x -= 0.5f;
-
-					break;
-				}
-				case 2:
-				{
-					center_y -= 0.5f;
-
-					break;
-				}
-				case 3:
-				{
-					center_x += 0.5f;
-				}
-			}
-
-			for (Position& mino : minos)
-			{
-				float x = mino.x - center_x;
-				float y = mino.y - center_y;
-
 				if (0 == i_clockwise)
 				{
-					mino.x = static_cast<char>(center_x + y);
-					mino.y = static_cast<char>(center_y - x);
+					rotation = (3 + rotation) % 4;
 				}
 				else
 				{
-					mino.x = static_cast<char>(center_x - y);
-					mino.y = static_cast<char>(center_y + x);
-				}
-			}
-		}
-		else
-		{
-			for (unsigned char a = 1; a < minos.size(); a++)
-			{
-				char x = minos[a].x - minos[0].x;
-				char y = minos[a].y - minos[0].y;
-
-				if (0 == i_clockwise)
-				{
-					minos[a].x = y + minos[0].x;
-					minos[a].y = minos[0].y - x;
-				}
-				else
-				{
-					minos[a].x = minos[0].x - y;
-					minos[a].y = x + minos[0].y;
-				}
-			}
-		}
-
-		for (Position& wall_kick : get_wall_kick_data(0 == shape, rotation, next_rotation))
-		{
-			bool can_turn = 1;
-
-			for (Position& mino : minos)
-			{
-				if (0 > mino.x + wall_kick.x || COLUMNS <= mino.x + wall_kick.x || ROWS <= mino.y + wall_kick.y)
-				{
-					can_turn = 0;
-
-					break;
-				}
-
-				if (0 > mino.y + wall_kick.y)
-				{
-					continue;
+					rotation = (1 + rotation) % 4;
 				}
-				else if (0 < i_matrix[mino.x + wall_kick.x][mino.y + wall_kick.y])
-				{
-					can_turn = 0;
 
-					break;
-				}
-			}
-
-			if (1 == can_turn)
-			{
-				rotation = next_rotation;
+				ghost_valid = 0;
 
 				for (Position& mino : minos)
 				{
@@ -233,70 +126,57 @@ void Tetromino::rotate(bool i_clockwise, const std::vector<std::vector<unsigned
 					mino.y += wall_kick.y;
 				}
 
-				return;
+				return 1;
 			}
 		}
 
-		minos = current_minos;
+		//None of the wall kicks worked, so we turn the minos back.
+		for (unsigned char a = 0; a < minos.size(); a++)
+		{
+			minos[a].x -= turn.minos[a].x;
+			minos[a].y -= turn.minos[a].y;
+		}
 	}
+
+	return 0;
 }
 
-void Tetromino::update_matrix(std::vector<std::vector<unsigned char>>& i_matrix)
+void Tetromino::update_matrix(Board& i_matrix) const
 {
-	for (Position& mino : minos)
+	for (const Position& mino : minos)
 	{
 		if (0 > mino.y)
 		{
 			continue;
 		}
 
-		i_matrix[mino.x][mino.y] = 1 + shape;
+		i_matrix.set_cell(mino.x, mino.y, 1 + shape);
 	}
 }
 
-std::vector<Position> Tetromino::get_ghost_minos(const std::vector<std::vector<unsigned char>>& i_matrix)
+const std::array<Position, 4>& Tetromino::get_ghost_minos(const Board& i_matrix)
 {
-	bool keep_falling = 1;
-
-	unsigned char total_movement = 0;
-
-	std::vector<Position> ghost_minos = minos;
-
-	while (1 == keep_falling)
+	if (0 == ghost_valid || &i_matrix != ghost_matrix || i_matrix.get_revision() != ghost_revision)
 	{
-		total_movement++;
+		unsigned char total_movement = i_matrix.get_drop_distance(minos);
 
-		for (Position& mino : minos)
-		{
-			if (ROWS == total_movement + mino.y)
-			{
-				keep_falling = 0;
-
-				break;
-			}
-
-			if (0 > total_movement + mino.y)
-			{
-				continue;
-			}
-			else if (0 < i_matrix[mino.x][total_movement + mino.y])
-			{
-				keep_falling = 0;
+		ghost_minos = minos;
 
-				break;
-			}
+		for (Position& mino : ghost_minos)
+		{
+			mino.y += total_movement;
 		}
-	}
 
-	for (Position& mino : ghost_minos)
-	{
-		mino.y += total_movement - 1;
+		ghost_valid = 1;
+		ghost_revision = i_matrix.get_revision();
+
+		ghost_matrix = &i_matrix;
 	}
 
 	return ghost_minos;
 }
 
-std::vector<Position> Tetromino::get_minos()
+const std::array<Position, 4>& Tetromino::get_minos() const
 {
 	return minos;
-}
\ No newline at end of file
+}
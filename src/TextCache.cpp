@@ -0,0 +1,160 @@
+#include <SFML/Graphics.hpp>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "TextCache.hpp"
+
+constexpr unsigned char CHARACTER_SIZE = 10;
+
+//Appends the position and the string to i_key, so that the same string drawn somewhere else is another text.
+static void make_key(unsigned short i_x, unsigned short i_y, const std::string& i_text, std::string& i_key)
+{
+	i_key.push_back(static_cast<char>(i_x >> 8));
+	i_key.push_back(static_cast<char>(i_x));
+	i_key.push_back(static_cast<char>(i_y >> 8));
+	i_key.push_back(static_cast<char>(i_y));
+	//The length keeps the keys of different sets of labels apart.
+	i_key.append(std::to_string(i_text.size()));
+	i_key.push_back(':');
+	i_key.append(i_text);
+}
+
+TextCache::TextCache() :
+	frame(0),
+	font(nullptr)
+{
+}
+
+void TextCache::build(unsigned short i_x, unsigned short i_y, const std::string& i_text, sf::VertexArray& i_vertices) const
+{
+	char32_t previous_character = 0;
+
+	float x = i_x;
+	//Like sf::Text, the first line sits on a baseline one character size below the top.
+	float y = i_y + CHARACTER_SIZE;
+
+	i_vertices.setPrimitiveType(sf::PrimitiveType::Triangles);
+
+	for (char character : i_text)
+	{
+		char32_t current_character = static_cast<unsigned char>(character);
+
+		if ('\n' == character)
+		{
+			previous_character = 0;
+
+			x = i_x;
+			y += CHARACTER_SIZE;
+
+			continue;
+		}
+
+		x += font->getKerning(previous_character, current_character, CHARACTER_SIZE);
+
+		previous_character = current_character;
+
+		const sf::Glyph& glyph = font->getGlyph(current_character, CHARACTER_SIZE, 0);
+
+		float left = x + glyph.bounds.position.x;
+		float top = y + glyph.bounds.position.y;
+		float right = left + glyph.bounds.size.x;
+		float bottom = top + glyph.bounds.size.y;
+
+		float texture_left = static_cast<float>(glyph.textureRect.position.x);
+		float texture_top = static_cast<float>(glyph.textureRect.position.y);
+		float texture_right = texture_left + glyph.textureRect.size.x;
+		float texture_bottom = texture_top + glyph.textureRect.size.y;
+
+		i_vertices.append({sf::Vector2f(left, top), sf::Color::White, sf::Vector2f(texture_left, texture_top)});
+		i_vertices.append({sf::Vector2f(right, top), sf::Color::White, sf::Vector2f(texture_right, texture_top)});
+		i_vertices.append({sf::Vector2f(left, bottom), sf::Color::White, sf::Vector2f(texture_left, texture_bottom)});
+		i_vertices.append({sf::Vector2f(left, bottom), sf::Color::White, sf::Vector2f(texture_left, texture_bottom)});
+		i_vertices.append({sf::Vector2f(right, top), sf::Color::White, sf::Vector2f(texture_right, texture_top)});
+		i_vertices.append({sf::Vector2f(right, bottom), sf::Color::White, sf::Vector2f(texture_right, texture_bottom)});
+
+		x += glyph.advance;
+	}
+}
+
+void TextCache::add_label(unsigned short i_x, unsigned short i_y, const std::string& i_text)
+{
+	make_key(i_x, i_y, i_text, label_key);
+
+	labels.push_back({sf::Vector2<unsigned short>(i_x, i_y), i_text});
+}
+
+void TextCache::draw(unsigned short i_x, unsigned short i_y, const std::string& i_text, sf::RenderTarget& i_target)
+{
+	if (nullptr == font)
+	{
+		return;
+	}
+
+	text_key.clear();
+
+	make_key(i_x, i_y, i_text, text_key);
+
+	std::unordered_map<std::string, Entry>::iterator entry = entries.find(text_key);
+
+	if (entries.end() == entry)
+	{
+		entry = entries.emplace(text_key, Entry{frame, sf::VertexArray()}).first;
+
+		build(i_x, i_y, i_text, entry->second.vertices);
+	}
+
+	entry->second.frame = frame;
+
+	i_target.draw(entry->second.vertices, sf::RenderStates(&font->getTexture(CHARACTER_SIZE)));
+}
+
+void TextCache::draw_labels(sf::RenderTarget& i_target)
+{
+	if (nullptr != font && 0 < labels.size())
+	{
+		std::unordered_map<std::string, sf::VertexArray>::iterator label_array = label_arrays.find(label_key);
+
+		if (label_arrays.end() == label_array)
+		{
+			label_array = label_arrays.emplace(label_key, sf::VertexArray()).first;
+
+			for (const std::pair<sf::Vector2<unsigned short>, std::string>& label : labels)
+			{
+				build(label.first.x, label.first.y, label.second, label_array->second);
+			}
+		}
+
+		i_target.draw(label_array->second, sf::RenderStates(&font->getTexture(CHARACTER_SIZE)));
+	}
+
+	label_key.clear();
+
+	labels.clear();
+}
+
+void TextCache::end_frame()
+{
+	for (std::unordered_map<std::string, Entry>::iterator a = entries.begin(); a != entries.end();)
+	{
+		if (frame != a->second.frame)
+		{
+			a = entries.erase(a);
+		}
+		else
+		{
+			a++;
+		}
+	}
+
+	frame++;
+}
+
+void TextCache::set_font(const sf::Font& i_font)
+{
+	font = &i_font;
+
+	entries.clear();
+	label_arrays.clear();
+}
@@ -0,0 +1,134 @@
+#include <SFML/Graphics.hpp>
+#include <algorithm>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "TextureAtlas.hpp"
+
+//The atlas is at least this wide, so that small images share rows.
+constexpr unsigned short MIN_ATLAS_WIDTH = 512;
+
+//Transparent pixels between the images, so that nothing bleeds into its neighbours when scaled.
+constexpr unsigned char PADDING = 1;
+
+//The white region is the middle pixel of a 3x3 white square, for the same reason.
+constexpr unsigned char WHITE_SIZE = 3;
+
+void TextureAtlas::add_image(const std::string& i_name, const sf::Image& i_image)
+{
+	sf::Vector2i size(i_image.getSize());
+
+	entries.push_back({&i_image, sf::IntRect(sf::Vector2i(0, 0), size), i_name});
+}
+
+void TextureAtlas::add_tiles(const std::string& i_name, const sf::Image& i_image)
+{
+	int tile_size = static_cast<int>(i_image.getSize().y);
+
+	if (0 == tile_size)
+	{
+		return;
+	}
+
+	for (int a = 0; a < static_cast<int>(i_image.getSize().x) / tile_size; a++)
+	{
+		entries.push_back({&i_image, sf::IntRect(sf::Vector2i(tile_size * a, 0), sf::Vector2i(tile_size, tile_size)), i_name + std::to_string(a)});
+	}
+}
+
+bool TextureAtlas::build()
+{
+	unsigned atlas_height = 0;
+	unsigned atlas_width = MIN_ATLAS_WIDTH;
+	unsigned row_height = 0;
+	unsigned x = 0;
+
+	//Where every entry goes, in the same order as the entries.
+	std::vector<sf::Vector2u> positions(entries.size());
+
+	std::vector<unsigned short> order(entries.size());
+
+	for (unsigned short a = 0; a < order.size(); a++)
+	{
+		order[a] = a;
+
+		atlas_width = std::max<unsigned>(atlas_width, entries[a].source.size.x + PADDING);
+	}
+
+	//Tallest first, so every row wastes as little space as possible.
+	std::stable_sort(order.begin(), order.end(), [&](unsigned short i_a, unsigned short i_b)
+	{
+		return entries[i_a].source.size.y > entries[i_b].source.size.y;
+	});
+
+	for (unsigned short index : order)
+	{
+		sf::Vector2u size(entries[index].source.size);
+
+		if (atlas_width < x + size.x)
+		{
+			atlas_height += row_height + PADDING;
+			row_height = 0;
+			x = 0;
+		}
+
+		positions[index] = sf::Vector2u(x, atlas_height);
+
+		row_height = std::max(row_height, size.y);
+		x += size.x + PADDING;
+	}
+
+	//The white square gets a row of its own at the bottom.
+	atlas_height += row_height + PADDING;
+
+	sf::Image image(sf::Vector2u(atlas_width, atlas_height + WHITE_SIZE), sf::Color::Transparent);
+
+	regions.clear();
+
+	for (unsigned short a = 0; a < entries.size(); a++)
+	{
+		if (0 == image.copy(*entries[a].image, positions[a], entries[a].source))
+		{
+			return 0;
+		}
+
+		regions[entries[a].name] = sf::IntRect(sf::Vector2i(positions[a]), entries[a].source.size);
+	}
+
+	for (unsigned char a = 0; a < WHITE_SIZE; a++)
+	{
+		for (unsigned char b = 0; b < WHITE_SIZE; b++)
+		{
+			image.setPixel(sf::Vector2u(a, atlas_height + b), sf::Color::White);
+		}
+	}
+
+	regions["white"] = sf::IntRect(sf::Vector2i(1, atlas_height + 1), sf::Vector2i(1, 1));
+
+	entries.clear();
+
+	return texture.loadFromImage(image);
+}
+
+bool TextureAtlas::has_region(const std::string& i_name) const
+{
+	return regions.end() != regions.find(i_name);
+}
+
+sf::IntRect TextureAtlas::get_region(const std::string& i_name) const
+{
+	std::unordered_map<std::string, sf::IntRect>::const_iterator region = regions.find(i_name);
+
+	if (regions.end() == region)
+	{
+		region = regions.find("white");
+	}
+
+	return regions.end() == region ? sf::IntRect() : region->second;
+}
+
+const sf::Texture& TextureAtlas::get_texture() const
+{
+	return texture;
+}
@@ -0,0 +1,183 @@
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "ThreadPool.hpp"
+
+//Which worker of which pool the current thread is, so tasks pushed from inside a task stay on that worker's queue.
+static thread_local const ThreadPool* current_pool = nullptr;
+static thread_local unsigned current_worker = 0;
+
+ThreadPool::ThreadPool(unsigned i_thread_count) :
+	stopping(0),
+	pending_tasks(0),
+	queued_tasks(0),
+	next_worker(0)
+{
+	i_thread_count = std::max(1u, i_thread_count);
+
+	for (unsigned a = 0; a < i_thread_count; a++)
+	{
+		workers.push_back(std::make_unique<Worker>());
+	}
+
+	for (unsigned a = 0; a < i_thread_count; a++)
+	{
+		threads.emplace_back(&ThreadPool::work, this, a);
+	}
+}
+
+ThreadPool::~ThreadPool()
+{
+	{
+		std::lock_guard<std::mutex> lock(wake_mutex);
+
+		stopping = 1;
+	}
+
+	wake_condition.notify_all();
+
+	for (std::thread& thread : threads)
+	{
+		thread.join();
+	}
+}
+
+std::function<void()> ThreadPool::pop_task(unsigned i_worker)
+{
+	std::function<void()> task;
+
+	if (0 == queued_tasks.load())
+	{
+		return task;
+	}
+
+	//Our own queue first, newest task first.
+	{
+		Worker& worker = *workers[i_worker];
+
+		std::lock_guard<std::mutex> lock(worker.mutex);
+
+		if (0 == worker.tasks.empty())
+		{
+			task = std::move(worker.tasks.back());
+
+			worker.tasks.pop_back();
+		}
+	}
+
+	//Then stealing the oldest task of another worker.
+	for (unsigned a = 1; !task && a < workers.size(); a++)
+	{
+		Worker& victim = *workers[(a + i_worker) % workers.size()];
+
+		std::lock_guard<std::mutex> lock(victim.mutex);
+
+		if (0 == victim.tasks.empty())
+		{
+			task = std::move(victim.tasks.front());
+
+			victim.tasks.pop_front();
+		}
+	}
+
+	if (task)
+	{
+		queued_tasks--;
+	}
+
+	return task;
+}
+
+void ThreadPool::work(unsigned i_worker)
+{
+	current_pool = this;
+	current_worker = i_worker;
+
+	while (1)
+	{
+		std::function<void()> task = pop_task(i_worker);
+
+		if (task)
+		{
+			task();
+
+			pending_tasks--;
+
+			continue;
+		}
+
+		std::unique_lock<std::mutex> lock(wake_mutex);
+
+		wake_condition.wait(lock, [this]()
+		{
+			return 1 == stopping || 0 < queued_tasks.load();
+		});
+
+		if (1 == stopping)
+		{
+			return;
+		}
+	}
+}
+
+unsigned ThreadPool::get_thread_count() const
+{
+	return static_cast<unsigned>(threads.size());
+}
+
+unsigned ThreadPool::get_thread_index() const
+{
+	return this == current_pool ? current_worker : get_thread_count();
+}
+
+void ThreadPool::push(std::function<void()> i_task)
+{
+	unsigned worker_index = this == current_pool ? current_worker : next_worker++ % workers.size();
+
+	pending_tasks++;
+
+	{
+		//Taking the lock so that no worker can miss the wake up between checking the queues and going to sleep.
+		std::lock_guard<std::mutex> lock(wake_mutex);
+
+		queued_tasks++;
+	}
+
+	{
+		Worker& worker = *workers[worker_index];
+
+		std::lock_guard<std::mutex> lock(worker.mutex);
+
+		worker.tasks.push_back(std::move(i_task));
+	}
+
+	wake_condition.notify_one();
+}
+
+void ThreadPool::wait()
+{
+	unsigned worker_index = this == current_pool ? current_worker : 0;
+
+	while (0 < pending_tasks.load())
+	{
+		std::function<void()> task = pop_task(worker_index);
+
+		if (task)
+		{
+			task();
+
+			pending_tasks--;
+		}
+		else
+		{
+			std::this_thread::yield();
+		}
+	}
+}
@@ -0,0 +1,96 @@
+#include <atomic>
+#include <cstring>
+#include <memory>
+
+#include "TranspositionTable.hpp"
+
+TranspositionTable::TranspositionTable(unsigned char i_size_bits) :
+	search(0),
+	mask((1ull << i_size_bits) - 1),
+	hits(0),
+	misses(0),
+	slots(new Slot[2ull << i_size_bits])
+{
+	clear();
+}
+
+void TranspositionTable::clear()
+{
+	for (unsigned long long a = 0; a < 2 * (1 + mask); a++)
+	{
+		slots[a].check.store(0, std::memory_order_relaxed);
+		slots[a].data.store(0, std::memory_order_relaxed);
+	}
+}
+
+void TranspositionTable::count_lookups(unsigned long long i_hits, unsigned long long i_misses)
+{
+	hits.fetch_add(i_hits, std::memory_order_relaxed);
+	misses.fetch_add(i_misses, std::memory_order_relaxed);
+}
+
+void TranspositionTable::new_search()
+{
+	search++;
+}
+
+void TranspositionTable::store(unsigned long long i_key, float i_score)
+{
+	unsigned score_bits;
+
+	std::memcpy(&score_bits, &i_score, sizeof(score_bits));
+
+	unsigned long long data = score_bits | static_cast<unsigned long long>(search) << 32;
+
+	Slot* bucket = &slots[2 * (i_key & mask)];
+
+	unsigned char target = 1;
+
+	unsigned long long first_data = bucket[0].data.load(std::memory_order_relaxed);
+	unsigned long long first_key = first_data ^ bucket[0].check.load(std::memory_order_relaxed);
+	unsigned long long second_key = bucket[1].data.load(std::memory_order_relaxed) ^ bucket[1].check.load(std::memory_order_relaxed);
+
+	//A matrix that is already here is overwritten where it is, so that it's never in both slots.
+	if (i_key == first_key)
+	{
+		target = 0;
+	}
+	else if (i_key != second_key && (0 == first_key || search != static_cast<unsigned char>(first_data >> 32)))
+	{
+		target = 0;
+	}
+
+	bucket[target].data.store(data, std::memory_order_relaxed);
+	bucket[target].check.store(i_key ^ data, std::memory_order_relaxed);
+}
+
+bool TranspositionTable::find(unsigned long long i_key, float& i_score) const
+{
+	const Slot* bucket = &slots[2 * (i_key & mask)];
+
+	for (unsigned char a = 0; a < 2; a++)
+	{
+		unsigned long long data = bucket[a].data.load(std::memory_order_relaxed);
+
+		if (i_key == (data ^ bucket[a].check.load(std::memory_order_relaxed)))
+		{
+			unsigned score_bits = static_cast<unsigned>(data);
+
+			std::memcpy(&i_score, &score_bits, sizeof(i_score));
+
+			return 1;
+		}
+	}
+
+	return 0;
+}
+
+unsigned long long TranspositionTable::get_hits() const
+{
+	return hits.load(std::memory_order_relaxed);
+}
+
+unsigned long long TranspositionTable::get_misses() const
+{
+	return misses.load(std::memory_order_relaxed);
+}
@@ -0,0 +1,386 @@
+#include <array>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "Global.hpp"
+#include "Board.hpp"
+#include "Tetromino.hpp"
+#include "Randomizer.hpp"
+#include "PieceQueue.hpp"
+#include "GameState.hpp"
+#include "ThreadPool.hpp"
+#include "MoveGenerator.hpp"
+#include "TranspositionTable.hpp"
+#include "Bot.hpp"
+#include "BatchFeatures.hpp"
+#include "InputQueue.hpp"
+
+//Every test is generated from this seed, so a failure happens again in the next run.
+constexpr unsigned TEST_SEED = 20240101;
+
+//The sizes the boards are tested at, from the smallest we support to the largest, with odd ones in between.
+constexpr std::array<std::array<unsigned char, 2>, 6> TEST_SIZES = {{{4, 4}, {5, 9}, {10, 20}, {13, 31}, {31, 40}, {32, 48}}};
+
+//A random board with i_locked_rows floor rows at the bottom. Some rows are a single color and some are full, so every feature has something to count.
+static Board make_random_board(std::mt19937& i_random_engine, unsigned char i_width, unsigned char i_height, unsigned char i_locked_rows)
+{
+	Board board(i_width, i_height);
+
+	unsigned char density = static_cast<unsigned char>(i_random_engine() % 101);
+	unsigned char empty_rows = static_cast<unsigned char>(i_random_engine() % (1 + i_height));
+
+	for (unsigned char a = empty_rows; a < i_height - i_locked_rows; a++)
+	{
+		unsigned char row_color = 0 == i_random_engine() % 4 ? static_cast<unsigned char>(1 + i_random_engine() % 7) : 0;
+
+		for (unsigned char b = 0; b < i_width; b++)
+		{
+			if (i_random_engine() % 100 < density)
+			{
+				board.set_cell(b, a, 0 == row_color ? static_cast<unsigned char>(1 + i_random_engine() % 7) : row_color);
+			}
+		}
+	}
+
+	for (unsigned char a = 0; a < i_locked_rows; a++)
+	{
+		board.fill_row(static_cast<unsigned char>(i_height - 1 - a), 8);
+	}
+
+	return board;
+}
+
+//One of the edits the game makes to a board, picked at random above the i_locked_rows floor rows. Emptying cells under others is what leaves overhangs.
+static void apply_random_edit(std::mt19937& i_random_engine, unsigned char i_locked_rows, Board& i_board)
+{
+	unsigned char x = static_cast<unsigned char>(i_random_engine() % i_board.get_width());
+	unsigned char y = static_cast<unsigned char>(i_random_engine() % (i_board.get_height() - i_locked_rows));
+
+	switch (i_random_engine() % 16)
+	{
+		case 0:
+		{
+			i_board.fill_row(y, static_cast<unsigned char>(1 + i_random_engine() % 7));
+
+			break;
+		}
+		case 1:
+		case 2:
+		{
+			i_board.clear_full_rows(i_locked_rows);
+
+			break;
+		}
+		case 3:
+		case 4:
+		case 5:
+		{
+			i_board.set_cell(x, y, 0);
+
+			break;
+		}
+		default:
+		{
+			i_board.set_cell(x, y, static_cast<unsigned char>(1 + i_random_engine() % 7));
+		}
+	}
+}
+
+//get_batch_features against get_features, with batches that fill some lanes only partly.
+static bool test_batch_features()
+{
+	unsigned failed = 0;
+
+	std::mt19937 random_engine(TEST_SEED);
+
+	std::vector<BotFeatures> features;
+
+	std::vector<Board> matrices;
+
+	std::vector<unsigned> line_points;
+
+	for (const std::array<unsigned char, 2>& size : TEST_SIZES)
+	{
+		for (unsigned a = 0; a < 200; a++)
+		{
+			unsigned char locked_rows = static_cast<unsigned char>(random_engine() % size[1]);
+
+			//Up to 2 full lanes of AVX2 and then some.
+			std::size_t batch_size = 1 + random_engine() % 19;
+
+			matrices.clear();
+			line_points.clear();
+
+			for (std::size_t b = 0; b < batch_size; b++)
+			{
+				matrices.push_back(make_random_board(random_engine, size[0], size[1], locked_rows));
+				line_points.push_back(random_engine() % 2000);
+			}
+
+			get_batch_features(matrices, line_points, locked_rows, features);
+
+			if (batch_size != features.size())
+			{
+				std::cerr << "get_batch_features: " << features.size() << " results for " << batch_size << " matrices" << std::endl;
+
+				return 0;
+			}
+
+			for (std::size_t b = 0; b < batch_size; b++)
+			{
+				BotFeatures reference = get_features(matrices[b], line_points[b], locked_rows);
+
+				for (unsigned char c = 0; c < BOT_FEATURE_COUNT; c++)
+				{
+					if (reference[c] != features[b][c])
+					{
+						std::cerr << "get_batch_features: feature " << static_cast<unsigned>(c) << " of matrix " << b << " of " << batch_size << " (" << static_cast<unsigned>(size[0]) << "x" << static_cast<unsigned>(size[1]) << ") is " << features[b][c] << " instead of " << reference[c] << std::endl;
+
+						failed++;
+					}
+				}
+			}
+		}
+	}
+
+	return 0 == failed;
+}
+
+//The column heights and drop distances of the board against probing it a row at a time, after random edits that leave overhangs and locked rows behind.
+static bool test_board()
+{
+	unsigned failed = 0;
+
+	std::mt19937 random_engine(TEST_SEED);
+
+	for (const std::array<unsigned char, 2>& size : TEST_SIZES)
+	{
+		for (unsigned a = 0; a < 200; a++)
+		{
+			unsigned char locked_rows = static_cast<unsigned char>(random_engine() % (size[1] / 2));
+
+			Board board(size[0], size[1]);
+
+			for (unsigned char b = 0; b < locked_rows; b++)
+			{
+				board.fill_row(static_cast<unsigned char>(size[1] - 1 - b), 8);
+			}
+
+			for (unsigned b = 0; b < 100; b++)
+			{
+				apply_random_edit(random_engine, locked_rows, board);
+
+				for (unsigned char c = 0; c < size[0]; c++)
+				{
+					unsigned char column_height = 0;
+
+					for (unsigned char d = 0; d < size[1]; d++)
+					{
+						if (0 != (board.get_row(d) & (1u << c)))
+						{
+							column_height = size[1] - d;
+
+							break;
+						}
+					}
+
+					if (column_height != board.get_column_height(c))
+					{
+						std::cerr << "board: column " << static_cast<unsigned>(c) << " (" << static_cast<unsigned>(size[0]) << "x" << static_cast<unsigned>(size[1]) << ") is " << static_cast<unsigned>(board.get_column_height(c)) << " high instead of " << static_cast<unsigned>(column_height) << std::endl;
+
+						failed++;
+					}
+				}
+
+				//Any 4 free cells, some of them above the top or under an overhang.
+				std::array<Position, 4> minos;
+
+				for (Position& mino : minos)
+				{
+					do
+					{
+						mino.x = static_cast<signed char>(random_engine() % size[0]);
+						mino.y = static_cast<signed char>(static_cast<int>(random_engine() % (2 + size[1])) - 2);
+					}
+					while (0 <= mino.y && 0 != (board.get_row(mino.y) & (1u << mino.x)));
+				}
+
+				unsigned char drop_distance = 0;
+
+				while (0 == board.collides(minos, 0, 1 + drop_distance))
+				{
+					drop_distance++;
+				}
+
+				if (drop_distance != board.get_drop_distance(minos))
+				{
+					std::cerr << "board: the drop distance (" << static_cast<unsigned>(size[0]) << "x" << static_cast<unsigned>(size[1]) << ") is " << static_cast<unsigned>(board.get_drop_distance(minos)) << " instead of " << static_cast<unsigned>(drop_distance) << std::endl;
+
+					failed++;
+				}
+			}
+		}
+	}
+
+	return 0 == failed;
+}
+
+//The hash and the row colors the board keeps up to date against working them out from every cell, after the same random edits as test_board.
+static bool test_hash()
+{
+	unsigned failed = 0;
+
+	std::mt19937 random_engine(TEST_SEED);
+
+	for (const std::array<unsigned char, 2>& size : TEST_SIZES)
+	{
+		for (unsigned a = 0; a < 200; a++)
+		{
+			unsigned char locked_rows = static_cast<unsigned char>(random_engine() % (size[1] / 2));
+
+			Board board(size[0], size[1]);
+
+			for (unsigned char b = 0; b < locked_rows; b++)
+			{
+				board.fill_row(static_cast<unsigned char>(size[1] - 1 - b), 8);
+			}
+
+			for (unsigned b = 0; b < 100; b++)
+			{
+				apply_random_edit(random_engine, locked_rows, board);
+
+				unsigned long long hash = 0;
+
+				for (unsigned char c = 0; c < size[1]; c++)
+				{
+					unsigned char row_color = 0;
+
+					for (unsigned char d = 0; d < size[0]; d++)
+					{
+						unsigned char cell = board.get_cell(d, c);
+
+						if (0 != cell)
+						{
+							hash ^= Board::get_cell_key(d, c, cell);
+
+							row_color = 0 == row_color || cell == row_color ? cell : MIXED_ROW_COLOR;
+						}
+					}
+
+					if (row_color != board.get_row_color(c))
+					{
+						std::cerr << "hash: row " << static_cast<unsigned>(c) << " (" << static_cast<unsigned>(size[0]) << "x" << static_cast<unsigned>(size[1]) << ") has the color " << static_cast<unsigned>(board.get_row_color(c)) << " instead of " << static_cast<unsigned>(row_color) << std::endl;
+
+						failed++;
+					}
+				}
+
+				if (hash != board.get_hash())
+				{
+					std::cerr << "hash: the hash (" << static_cast<unsigned>(size[0]) << "x" << static_cast<unsigned>(size[1]) << ") is " << board.get_hash() << " instead of " << hash << std::endl;
+
+					failed++;
+				}
+			}
+		}
+	}
+
+	return 0 == failed;
+}
+
+//The events of every frame against its keys, with bursts that overflow the queue. Every event has to change its key, so the game sees every press that the keys say happened.
+static bool test_input_queue()
+{
+	unsigned failed = 0;
+
+	std::mt19937 random_engine(TEST_SEED);
+
+	for (unsigned a = 0; a < 200; a++)
+	{
+		unsigned char keys = 0;
+
+		std::chrono::time_point<std::chrono::steady_clock> time = std::chrono::steady_clock::now();
+
+		InputQueue input_queue;
+
+		for (unsigned b = 0; b < 400; b++)
+		{
+			//Now and then, many more events than fit in the queue.
+			unsigned event_count = random_engine() % (0 == random_engine() % 10 ? 4 * INPUT_QUEUE_SIZE : 4);
+
+			for (unsigned c = 0; c < event_count; c++)
+			{
+				unsigned char key = static_cast<unsigned char>(1 << random_engine() % 7);
+
+				input_queue.push(key, 0 == (input_queue.get_keys() & key), time);
+
+				time += std::chrono::microseconds(random_engine() % 300);
+			}
+
+			InputFrame frame = input_queue.pop_frame(time - std::chrono::microseconds(FRAME_DURATION / 2));
+
+			for (unsigned char c = 0; c < frame.event_count; c++)
+			{
+				const InputEvent& event = frame.events[c];
+
+				if (event.pressed == (0 != (keys & event.key)) || (0 < c && event.time < frame.events[c - 1].time))
+				{
+					failed++;
+				}
+
+				keys = 1 == event.pressed ? keys | event.key : keys & ~event.key;
+			}
+
+			if (keys != frame.keys)
+			{
+				failed++;
+			}
+		}
+	}
+
+	if (0 < failed)
+	{
+		std::cerr << "input_queue: " << failed << " frames have events that don't match their keys" << std::endl;
+	}
+
+	return 0 == failed;
+}
+
+//Runs the test named by the argument, so that every one is its own ctest test.
+int main(int i_argument_count, char** i_arguments)
+{
+	bool passed = 0;
+
+	std::string test = 2 == i_argument_count ? i_arguments[1] : "";
+
+	if ("batch_features" == test)
+	{
+		passed = test_batch_features();
+	}
+	else if ("board" == test)
+	{
+		passed = test_board();
+	}
+	else if ("hash" == test)
+	{
+		passed = test_hash();
+	}
+	else if ("input_queue" == test)
+	{
+		passed = test_input_queue();
+	}
+	else
+	{
+		std::cerr << "Usage: " << i_arguments[0] << " batch_features|board|hash|input_queue" << std::endl;
+
+		return 2;
+	}
+
+	std::cout << test << (1 == passed ? ": passed" : ": failed") << std::endl;
+
+	return 1 == passed ? 0 : 1;
+}